@@ -0,0 +1,66 @@
+#include <GaiaFramework/Clients/LogRecorder.hpp>
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace Gaia::Framework::Clients;
+
+/// Count of lines recorded by every benchmark run.
+constexpr std::size_t TotalLines = 1 << 20;
+
+/**
+ * @brief Record lines with the given count of producer threads.
+ * @return Recorded lines per second, including the time to write all of them into the file.
+ */
+double MeasureLinesPerSecond(std::size_t producer_count, bool writer_thread)
+{
+    auto begin_time = std::chrono::steady_clock::now();
+    {
+        LogRecorder recorder("LogRecorderBenchmark");
+        if (writer_thread)
+        {
+            recorder.EnableWriterThread();
+        }
+
+        std::vector<std::thread> producers;
+        for (std::size_t producer_index = 0; producer_index < producer_count; ++producer_index)
+        {
+            producers.emplace_back([&recorder, producer_count](){
+                for (std::size_t line_index = 0; line_index < TotalLines / producer_count; ++line_index)
+                {
+                    recorder.RecordMessage("Benchmark line for the log recorder.", "Benchmark");
+                }
+            });
+        }
+        for (auto& producer : producers)
+        {
+            producer.join();
+        }
+    }
+    auto end_time = std::chrono::steady_clock::now();
+    return static_cast<double>(TotalLines) / std::chrono::duration<double>(end_time - begin_time).count();
+}
+
+int main()
+{
+    for (std::size_t producer_count : {1, 4, 16})
+    {
+        std::cout << producer_count << " producer(s): "
+                  << static_cast<std::size_t>(MeasureLinesPerSecond(producer_count, false))
+                  << " lines/s with the mutex, "
+                  << static_cast<std::size_t>(MeasureLinesPerSecond(producer_count, true))
+                  << " lines/s with the writer thread." << std::endl;
+    }
+
+    // Remove the log files produced by the benchmark.
+    for (const auto& entry : std::filesystem::directory_iterator("."))
+    {
+        if (entry.path().filename().string().rfind("LogRecorderBenchmark", 0) == 0)
+        {
+            std::filesystem::remove(entry.path());
+        }
+    }
+    return 0;
+}
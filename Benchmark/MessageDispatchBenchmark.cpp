@@ -0,0 +1,113 @@
+#include <GaiaFramework/Service.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <string_view>
+
+/// Count of heap allocations made by this program.
+static std::atomic<std::size_t> AllocationCount {0};
+
+void* operator new(std::size_t size)
+{
+    AllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (auto* memory = std::malloc(size > 0 ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+/// Count of messages dispatched by every benchmark run.
+constexpr std::size_t TotalMessages = 1 << 20;
+
+/**
+ * @brief Service which injects messages into its own dispatching entry points, no Redis server is needed.
+ * @details Commands are executed on the calling thread, as they are when no command thread is configured.
+ */
+class DispatchBenchmarkService : public Gaia::Framework::Service
+{
+private:
+    /// Accumulated by handlers, so they can not be optimized away.
+    std::size_t Checksum {0};
+
+public:
+    DispatchBenchmarkService() : Gaia::Framework::Service("DispatchBenchmark")
+    {
+        AddCommand("view", [this](std::string_view content){
+            Checksum += content.size();
+        });
+        AddCommand("string", [this](const std::string& content){
+            Checksum += content.size();
+        });
+        AddSubscription("benchmark/view", [this](std::string_view channel, std::string_view content){
+            Checksum += channel.size() + content.size();
+        });
+        AddSubscription("benchmark/string", [this](const std::string& content){
+            Checksum += content.size();
+        });
+    }
+
+    /**
+     * @brief Dispatch messages of the given channel and print the allocations and time per message.
+     * @param is_command True to dispatch on the command path, false to dispatch on the subscription path.
+     */
+    void Measure(const std::string& title, const std::string& channel, const std::string& content, bool is_command)
+    {
+        auto begin_allocations = AllocationCount.load(std::memory_order_relaxed);
+        auto begin_time = std::chrono::steady_clock::now();
+        for (std::size_t message_index = 0; message_index < TotalMessages; ++message_index)
+        {
+            if (is_command)
+            {
+                HandleCommandMessage(channel, content);
+            }
+            else
+            {
+                HandleMessage(channel, content);
+            }
+        }
+        auto end_time = std::chrono::steady_clock::now();
+        auto allocations = AllocationCount.load(std::memory_order_relaxed) - begin_allocations;
+
+        std::cout << title << ": "
+                  << static_cast<double>(allocations) / static_cast<double>(TotalMessages) << " allocations/message, "
+                  << std::chrono::duration<double, std::nano>(end_time - begin_time).count() /
+                     static_cast<double>(TotalMessages) << " ns/message." << std::endl;
+    }
+
+    [[nodiscard]] std::size_t GetChecksum() const noexcept
+    {
+        return Checksum;
+    }
+};
+
+int main()
+{
+    // Long enough to be allocated on the heap if it was copied.
+    const std::string content(256, 'x');
+
+    DispatchBenchmarkService service;
+    service.Measure("Command with a std::string_view handler",
+                    "DispatchBenchmark/command/view", content, true);
+    service.Measure("Command with a std::string handler",
+                    "DispatchBenchmark/command/string", content, true);
+    service.Measure("Command named by the content",
+                    "DispatchBenchmark/command", "view", true);
+    service.Measure("Subscription with a std::string_view handler",
+                    "benchmark/view", content, false);
+    service.Measure("Subscription with a std::string handler",
+                    "benchmark/string", content, false);
+
+    std::cout << "Checksum: " << service.GetChecksum() << std::endl;
+    return 0;
+}
@@ -0,0 +1,108 @@
+#include <GaiaFramework/Clients/RemoteBatch.hpp>
+#include <GaiaFramework/Codecs/TextCodec.hpp>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace Gaia::Framework;
+
+/// Count of rounds measured for every key count.
+constexpr std::size_t TotalRounds = 100;
+
+/// Measure the microseconds per round of the given function.
+template <typename FunctionType>
+double MeasureMicroseconds(FunctionType&& function)
+{
+    auto begin_time = std::chrono::steady_clock::now();
+    for (std::size_t round = 0; round < TotalRounds; ++round)
+    {
+        function();
+    }
+    auto end_time = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::micro>(end_time - begin_time).count() /
+           static_cast<double>(TotalRounds);
+}
+
+/**
+ * @brief Compare per-key commands with batches, for writing and reading the given count of keys.
+ * @details A Redis server is required, its address can be passed as the first argument.
+ */
+int main(int argument_count, char** arguments)
+{
+    std::string address = argument_count > 1 ? arguments[1] : "tcp://127.0.0.1:6379";
+    auto connection = std::make_shared<sw::redis::Redis>(address);
+    Clients::RemoteBatch batch(connection);
+
+    for (std::size_t key_count : {10, 100, 1000})
+    {
+        std::vector<std::string> names;
+        std::vector<std::pair<std::string, std::string>> texts;
+        for (std::size_t index = 0; index < key_count; ++index)
+        {
+            names.push_back("benchmark/sensors/" + std::to_string(index));
+            texts.emplace_back(names.back(), Codecs::EncodeText(static_cast<double>(index) * 0.5));
+        }
+        // Accumulated by reads, so they can not be optimized away.
+        double checksum = 0;
+
+        auto loop_set_time = MeasureMicroseconds([&](){
+            for (const auto& [name, text] : texts)
+            {
+                connection->set(name, text);
+            }
+        });
+        auto loop_get_time = MeasureMicroseconds([&](){
+            for (const auto& name : names)
+            {
+                auto text = connection->get(name);
+                if (text.has_value()) checksum += Codecs::DecodeText<double>(*text).value_or(0);
+            }
+        });
+        auto batch_set_time = MeasureMicroseconds([&](){
+            for (std::size_t index = 0; index < key_count; ++index)
+            {
+                batch.Set(names[index], static_cast<double>(index) * 0.5, std::chrono::milliseconds(60000));
+            }
+            batch.Execute();
+        });
+        auto batch_get_time = MeasureMicroseconds([&](){
+            std::vector<Clients::RemoteBatch::Reply<double>> replies;
+            replies.reserve(key_count);
+            for (const auto& name : names)
+            {
+                replies.push_back(batch.Get<double>(name));
+            }
+            batch.Execute();
+            for (const auto& reply : replies)
+            {
+                checksum += reply.Get().value_or(0);
+            }
+        });
+        auto mset_time = MeasureMicroseconds([&](){
+            connection->mset(texts.begin(), texts.end());
+        });
+        auto mget_time = MeasureMicroseconds([&](){
+            std::vector<sw::redis::OptionalString> values;
+            values.reserve(key_count);
+            connection->mget(names.begin(), names.end(), std::back_inserter(values));
+            for (const auto& value : values)
+            {
+                if (value.has_value()) checksum += Codecs::DecodeText<double>(*value).value_or(0);
+            }
+        });
+
+        std::cout << key_count << " keys, microseconds per round:" << std::endl
+                  << "  write: " << loop_set_time << " per-key SET, " << batch_set_time << " batch with TTLs, "
+                  << mset_time << " MSET" << std::endl
+                  << "  read:  " << loop_get_time << " per-key GET, " << batch_get_time << " batch, "
+                  << mget_time << " MGET" << std::endl
+                  << "  (" << checksum << ")" << std::endl;
+
+        connection->del(names.begin(), names.end());
+    }
+    return 0;
+}
@@ -0,0 +1,116 @@
+#include <GaiaFramework/Codecs/TextCodec.hpp>
+#include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace Gaia::Framework::Codecs;
+
+/// Count of values converted by every benchmark run.
+constexpr std::size_t TotalValues = 1 << 20;
+
+/// Measure the nanoseconds per invocation of the given function.
+template <typename FunctionType>
+double MeasureNanoseconds(FunctionType&& function)
+{
+    auto begin_time = std::chrono::steady_clock::now();
+    for (std::size_t index = 0; index < TotalValues; ++index)
+    {
+        function(index);
+    }
+    auto end_time = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end_time - begin_time).count() /
+           static_cast<double>(TotalValues);
+}
+
+/// Compare encoding and decoding of the given values with the previous implementation.
+template <typename ValueType>
+void Compare(const std::string& title, const std::vector<ValueType>& values)
+{
+    // Accumulated by conversions, so they can not be optimized away.
+    // Values are cast through std::int64_t, because casting negative doubles to unsigned integers is undefined.
+    std::size_t checksum = 0;
+
+    std::vector<std::string> texts;
+    texts.reserve(values.size());
+    for (const auto& value : values)
+    {
+        texts.push_back(EncodeText(value));
+    }
+
+    auto to_string_time = MeasureNanoseconds([&](std::size_t index){
+        checksum += std::to_string(values[index % values.size()]).size();
+    });
+    auto encode_time = MeasureNanoseconds([&](std::size_t index){
+        checksum += EncodeText(values[index % values.size()]).size();
+    });
+    auto lexical_cast_time = MeasureNanoseconds([&](std::size_t index){
+        try
+        {
+            checksum += static_cast<std::size_t>(
+                    static_cast<std::int64_t>(boost::lexical_cast<ValueType>(texts[index % texts.size()])));
+        }
+        catch (boost::bad_lexical_cast&)
+        {}
+    });
+    auto decode_time = MeasureNanoseconds([&](std::size_t index){
+        ValueType value {};
+        if (DecodeText(texts[index % texts.size()], value))
+        {
+            checksum += static_cast<std::size_t>(static_cast<std::int64_t>(value));
+        }
+    });
+
+    std::cout << title << ": encoding " << to_string_time << " ns with std::to_string, "
+              << encode_time << " ns with the codec; decoding "
+              << lexical_cast_time << " ns with boost::lexical_cast, "
+              << decode_time << " ns with the codec. (" << checksum % 10 << ")" << std::endl;
+}
+
+int main()
+{
+    std::vector<std::int64_t> integers;
+    std::vector<double> doubles;
+    for (std::size_t index = 0; index < 1024; ++index)
+    {
+        integers.push_back(static_cast<std::int64_t>(index * 2654435761ULL % 1000000007ULL) - 500000000);
+        doubles.push_back(static_cast<double>(integers.back()) / 1024.0 + 0.1);
+    }
+    Compare("Integers", integers);
+    Compare("Doubles", doubles);
+
+    // The previous implementation reported invalid texts with exceptions.
+    const std::string invalid_text = "not a number";
+    std::size_t failures = 0;
+    auto lexical_cast_time = MeasureNanoseconds([&](std::size_t){
+        try
+        {
+            static_cast<void>(boost::lexical_cast<double>(invalid_text));
+        }
+        catch (boost::bad_lexical_cast&)
+        {
+            ++failures;
+        }
+    });
+    auto decode_time = MeasureNanoseconds([&](std::size_t){
+        double value = 0;
+        if (!DecodeText(invalid_text, value)) ++failures;
+    });
+    std::cout << "Invalid texts: " << lexical_cast_time << " ns with boost::lexical_cast, "
+              << decode_time << " ns with the codec. (" << failures << " failures)" << std::endl;
+
+    // Texts of std::to_string lose precision, while texts of the codec should round-trip exactly.
+    std::size_t to_string_exact_count = 0;
+    std::size_t codec_exact_count = 0;
+    for (auto value : doubles)
+    {
+        if (boost::lexical_cast<double>(std::to_string(value)) == value) ++to_string_exact_count;
+        auto decoded_value = DecodeText<double>(EncodeText(value));
+        if (decoded_value.has_value() && *decoded_value == value) ++codec_exact_count;
+    }
+    std::cout << "Doubles round-tripped exactly by std::to_string: " << to_string_exact_count << "/"
+              << doubles.size() << ", by the codec: " << codec_exact_count << "/" << doubles.size() << std::endl;
+    return 0;
+}
@@ -2,6 +2,7 @@
 
 #include <sstream>
 #include <exception>
+#include <iterator>
 
 namespace Gaia::Framework::Clients
 {
@@ -30,19 +31,147 @@ namespace Gaia::Framework::Clients
     /// Get the string value of the given configuration item.
     std::optional<std::string> ConfigurationClient::Get(const std::string& name)
     {
-        return Connection->get(GenerateKeyName(UnitName, name));
+        if (!CacheEnabled.load(std::memory_order_relaxed) || IsCacheBypassed())
+        {
+            return Connection->get(GenerateKeyName(UnitName, name));
+        }
+
+        std::shared_lock lock(CacheMutex);
+        auto finder = Cache.find(name);
+        if (finder != Cache.end()) return finder->second;
+        lock.unlock();
+
+        auto generation = CacheGeneration.load();
+        auto value = Connection->get(GenerateKeyName(UnitName, name));
+        StoreCache(name, value, generation);
+        return value;
     }
 
     /// Update or add the value of the given configuration item.
     void ConfigurationClient::Set(const std::string &name, const std::string &value)
     {
         Connection->set(GenerateKeyName(UnitName, name), value);
+        if (CacheEnabled.load(std::memory_order_relaxed))
+        {
+            Invalidate(name);
+            StoreCache(name, value, CacheGeneration.load());
+        }
+        Connection->publish(UpdateChannel, UnitName + "/" + name);
+    }
+
+    /// Store a fetched value into the cache if no invalidation happened since the given generation.
+    void ConfigurationClient::StoreCache(const std::string& name, std::optional<std::string> value,
+                                         std::uint64_t generation)
+    {
+        std::unique_lock lock(CacheMutex);
+        if (CacheGeneration.load() != generation || !CacheEnabled.load()) return;
+        Cache.insert_or_assign(name, std::move(value));
+    }
+
+    /// Check whether the cache is bypassed because a reload of the unit is in progress or not.
+    bool ConfigurationClient::IsCacheBypassed() const noexcept
+    {
+        return std::chrono::steady_clock::now().time_since_epoch().count() < CacheBypassDeadline.load();
+    }
+
+    /// Cache values of the bound unit in this process.
+    void ConfigurationClient::EnableCache()
+    {
+        CacheEnabled = true;
+    }
+
+    /// Disable and clear the cache.
+    void ConfigurationClient::DisableCache()
+    {
+        CacheEnabled = false;
+        InvalidateAll();
+    }
+
+    /// Get values of the given configuration items in one round trip.
+    std::vector<std::optional<std::string>> ConfigurationClient::GetItems(const std::vector<std::string>& names)
+    {
+        std::vector<std::optional<std::string>> values;
+        if (names.empty()) return values;
+
+        std::vector<std::string> keys;
+        keys.reserve(names.size());
+        for (const auto& name : names)
+        {
+            keys.push_back(GenerateKeyName(UnitName, name));
+        }
+        values.reserve(names.size());
+        Connection->mget(keys.begin(), keys.end(), std::back_inserter(values));
+        return values;
+    }
+
+    /// Fetch values of the given configuration items into the cache in one round trip.
+    void ConfigurationClient::Preload(const std::vector<std::string>& names)
+    {
+        if (!CacheEnabled.load() || IsCacheBypassed() || names.empty()) return;
+
+        auto generation = CacheGeneration.load();
+        auto values = GetItems(names);
+
+        std::unique_lock lock(CacheMutex);
+        if (CacheGeneration.load() != generation) return;
+        for (std::size_t index = 0; index < names.size() && index < values.size(); ++index)
+        {
+            Cache.insert_or_assign(names[index], std::move(values[index]));
+        }
+    }
+
+    /// Remove the cached value of the given configuration item.
+    void ConfigurationClient::Invalidate(const std::string& name)
+    {
+        std::unique_lock lock(CacheMutex);
+        ++CacheGeneration;
+        Cache.erase(name);
+    }
+
+    /// Remove all cached values.
+    void ConfigurationClient::InvalidateAll()
+    {
+        std::unique_lock lock(CacheMutex);
+        ++CacheGeneration;
+        Cache.clear();
+    }
+
+    /// Invalidate cached values according to a notification message.
+    void ConfigurationClient::HandleNotification(const std::string& channel, const std::string& message)
+    {
+        if (!CacheEnabled.load(std::memory_order_relaxed)) return;
+
+        // An empty message or the unit name stands for the whole unit.
+        bool is_whole_unit = message.empty() || message == UnitName;
+        if (channel == LoadChannel)
+        {
+            if (!is_whole_unit) return;
+            // The loader writes the unit after this request, so values are not cached until it finishes.
+            auto deadline = std::chrono::steady_clock::now() + ReloadTimeout;
+            CacheBypassDeadline = deadline.time_since_epoch().count();
+            InvalidateAll();
+            return;
+        }
+        if (channel != UpdateChannel) return;
+
+        if (is_whole_unit)
+        {
+            // The reload is finished, values fetched during it are discarded by the invalidation.
+            CacheBypassDeadline = 0;
+            InvalidateAll();
+            return;
+        }
+        if (message.size() > UnitName.size() &&
+            message.compare(0, UnitName.size(), UnitName) == 0 && message[UnitName.size()] == '/')
+        {
+            Invalidate(message.substr(UnitName.size() + 1));
+        }
     }
 
-    /// Reload the configuration from the JSON file into the Redis server.
+    /// Request the loader to reload the configuration from the JSON file into the Redis server.
     void ConfigurationClient::Reload()
     {
-        Connection->publish("configurations/load", UnitName);
+        Connection->publish(LoadChannel, UnitName);
     }
 
     /// Apply the configuration in the Redis server to a JSON file.
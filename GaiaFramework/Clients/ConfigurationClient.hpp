@@ -3,8 +3,16 @@
 #include <string>
 #include <optional>
 #include <memory>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <sw/redis++/redis++.h>
-#include <boost/lexical_cast.hpp>
+
+#include "../Codecs/TextCodec.hpp"
 
 namespace Gaia::Framework::Clients
 {
@@ -28,7 +36,41 @@ namespace Gaia::Framework::Clients
         /// Connection to the Redis server.
         std::shared_ptr<sw::redis::Redis> Connection;
 
+        /// Whether values are cached in this process or not.
+        std::atomic_bool CacheEnabled {false};
+        /// Mutex for the cache.
+        std::shared_mutex CacheMutex;
+        /// Cached values of configuration items, std::nullopt for items known to be absent.
+        std::unordered_map<std::string, std::optional<std::string>> Cache;
+        /// Increased by every invalidation, values fetched before an invalidation will not be cached.
+        std::atomic<std::uint64_t> CacheGeneration {0};
+
+        /// Store a fetched value into the cache if no invalidation happened since the given generation.
+        void StoreCache(const std::string& name, std::optional<std::string> value, std::uint64_t generation);
+
+        /// Steady clock ticks until which values are read from the Redis server without being cached.
+        std::atomic<std::int64_t> CacheBypassDeadline {0};
+        /// Check whether the cache is bypassed because a reload of the unit is in progress or not.
+        [[nodiscard]] bool IsCacheBypassed() const noexcept;
+
     public:
+        /**
+         * @brief Channel on which reload requests of configuration units are published.
+         * @details
+         *  A request is published before the loader writes the unit, so caches are invalidated and bypassed
+         *  until the update notice of the unit arrives or ReloadTimeout passes.
+         */
+        static constexpr const char* LoadChannel = "configurations/load";
+        /**
+         * @brief Channel on which updates of configuration items are published.
+         * @details
+         *  Messages are "<unit>/<item>" for an updated item, or "<unit>" for a whole updated unit.
+         *  The loader publishes "<unit>" here after it has written a reloaded unit into the Redis server.
+         */
+        static constexpr const char* UpdateChannel = "configurations/update";
+        /// Maximum duration to wait for the update notice after a reload request, before values are read again.
+        static constexpr std::chrono::milliseconds ReloadTimeout {2000};
+
         /**
          * @brief Connect to the given Redis server and bind the given configuration unit.
          * @param unit_name Name of the configuration unit to bind.
@@ -56,17 +98,17 @@ namespace Gaia::Framework::Clients
 
         /**
          * @brief Get the value of the given configuration item and cast into desired type.
-         * @tparam ValueType The type of the value to cast into.
+         * @tparam ValueType The type of the value to cast into, parsed by Codecs::TextCodec.
          * @param name The name of the configuration item to get.
          * @return The casted value of the given configuration item,
-         *         or std::nullopt if the corresponding value does not exist.
+         *         or std::nullopt if the corresponding value does not exist or can not be parsed.
          */
         template <typename ValueType>
         std::optional<ValueType> Get(const std::string& name)
         {
             auto result = Get(name);
             if (!result.has_value()) return std::nullopt;
-            return boost::lexical_cast<ValueType>(*result);
+            return Codecs::DecodeText<ValueType>(*result);
         }
 
         /**
@@ -78,17 +120,64 @@ namespace Gaia::Framework::Clients
 
         /**
          * @brief Update or add the value of the given configuration item.
-         * @tparam ValueType The type of the value.
+         * @tparam ValueType The type of the value, converted to text by Codecs::TextCodec.
          * @param name The name of the configuration item.
          * @param value The value to add or update.
          */
         template <typename ValueType>
         void Set(const std::string& name, ValueType value)
         {
-            Set(name, std::to_string(value));
+            Set(name, Codecs::EncodeText(value));
         }
 
-        /// Reload the configuration from the JSON file into the Redis server.
+        /**
+         * @brief Cache values of the bound unit in this process.
+         * @details
+         *  Values are fetched on first access or by Preload(), then read from the cache,
+         *  until they are invalidated by HandleNotification() or Invalidate().
+         *  Notifications from LoadChannel and UpdateChannel should be passed to HandleNotification().
+         */
+        void EnableCache();
+        /// Disable and clear the cache, values will be read from the Redis server on every access.
+        void DisableCache();
+        /// Check whether values are cached in this process or not.
+        [[nodiscard]] inline bool IsCacheEnabled() const noexcept
+        {
+            return CacheEnabled.load(std::memory_order_relaxed);
+        }
+        /**
+         * @brief Get values of the given configuration items in one round trip.
+         * @param names Names of the configuration items to get.
+         * @return Values in the order of the names, std::nullopt for items which do not exist.
+         */
+        std::vector<std::optional<std::string>> GetItems(const std::vector<std::string>& names);
+
+        /// Get the name of the bound configuration unit.
+        [[nodiscard]] inline const std::string& GetUnitName() const noexcept
+        {
+            return UnitName;
+        }
+
+        /**
+         * @brief Fetch values of the given configuration items into the cache in one round trip.
+         * @param names Names of the configuration items to fetch.
+         */
+        void Preload(const std::vector<std::string>& names);
+        /// Remove the cached value of the given configuration item.
+        void Invalidate(const std::string& name);
+        /// Remove all cached values.
+        void InvalidateAll();
+        /**
+         * @brief Invalidate cached values according to a notification message.
+         * @param channel Channel of the notification, LoadChannel or UpdateChannel.
+         * @param message Content of the notification.
+         */
+        void HandleNotification(const std::string& channel, const std::string& message);
+
+        /**
+         * @brief Request the loader to reload the configuration from the JSON file into the Redis server.
+         * @details The reload is finished when the loader publishes the unit name on UpdateChannel.
+         */
         void Reload();
         /// Apply the configuration in the Redis server to a JSON file.
         void Apply();
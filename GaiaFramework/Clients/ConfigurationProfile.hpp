@@ -0,0 +1,199 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <optional>
+#include <functional>
+#include <type_traits>
+#include <GaiaBackground/GaiaBackground.hpp>
+
+#include "ConfigurationClient.hpp"
+#include "../Codecs/TextCodec.hpp"
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Typed snapshot of the configuration items of a unit.
+     * @tparam SettingsType Type of the struct of settings, it should be copyable.
+     * @details
+     *  Members of the settings struct are bound to configuration items,
+     *  then all of them are fetched in one MGET and parsed once per load.
+     *  Readers get an immutable snapshot, which is swapped atomically when the profile is reloaded.
+     * @code
+     *  struct Settings { int Rate {10}; std::string Mode {"fast"}; };
+     *  ConfigurationProfile<Settings> profile(*GetConfigurator());
+     *  profile.Bind("rate", &Settings::Rate).Bind("mode", &Settings::Mode);
+     *  profile.Load();
+     *  auto settings = profile.Get();
+     * @endcode
+     */
+    template <typename SettingsType>
+    class ConfigurationProfile
+    {
+    public:
+        /// Immutable snapshot of the settings.
+        using Snapshot = std::shared_ptr<const SettingsType>;
+
+    private:
+        /// Parse the text of an item into the bound member, returns false if the text is invalid.
+        using Parser = std::function<bool(SettingsType&, const std::string&)>;
+
+        /// Client of the configuration unit.
+        ConfigurationClient& Configurator;
+
+        /// Mutex for the bindings and loading.
+        std::mutex LoadMutex;
+        /// Names of the bound items.
+        std::vector<std::string> ItemNames;
+        /// Parsers of the bound items, in the order of the names.
+        std::vector<Parser> ItemParsers;
+        /// Names of the items which failed to be parsed in the last load.
+        std::vector<std::string> InvalidItems;
+
+        /// Current snapshot, only accessed by atomic operations.
+        Snapshot Current;
+
+        /// Mutex for the pending reload.
+        std::mutex ReloadMutex;
+        /// Time to load the profile if the update notice of a requested reload has not arrived.
+        std::optional<std::chrono::steady_clock::time_point> ReloadDeadline;
+
+        /// Load the profile when pending reloads time out, until the life flag is false.
+        void WaitForReloads(const std::atomic_bool& life_flag)
+        {
+            while (life_flag.load())
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                std::unique_lock lock(ReloadMutex);
+                if (!ReloadDeadline || std::chrono::steady_clock::now() < *ReloadDeadline) continue;
+                ReloadDeadline.reset();
+                lock.unlock();
+                try
+                {
+                    Load();
+                }
+                catch (sw::redis::Error&)
+                {}
+            }
+        }
+
+        /// Background worker which loads the profile when pending reloads time out, started by the first one.
+        Gaia::Background::BackgroundWorker Reloader;
+        /// Whether the background reloader is running or not.
+        std::atomic_bool ReloaderRunning {false};
+
+    public:
+        /**
+         * @brief Bind the configuration unit of the given client.
+         * @param configurator Client of the configuration unit, it should outlive this profile.
+         * @param defaults Values of items which do not exist in the configuration unit.
+         */
+        explicit ConfigurationProfile(ConfigurationClient& configurator, SettingsType defaults = {}) :
+            Configurator(configurator), Current(std::make_shared<const SettingsType>(std::move(defaults))),
+            Reloader([this](const std::atomic_bool& life_flag){
+                this->WaitForReloads(life_flag);
+            })
+        {}
+
+        /// Stop the background reloader.
+        ~ConfigurationProfile()
+        {
+            if (ReloaderRunning.exchange(false)) Reloader.Stop();
+        }
+
+        /**
+         * @brief Bind a member of the settings to a configuration item.
+         * @param item_name Name of the configuration item.
+         * @param member Pointer to the member, its value is parsed by Codecs::TextCodec.
+         * @return This profile, to chain bindings.
+         */
+        template <typename MemberType>
+        ConfigurationProfile& Bind(std::string item_name, MemberType SettingsType::* member)
+        {
+            std::unique_lock lock(LoadMutex);
+            ItemNames.push_back(std::move(item_name));
+            ItemParsers.emplace_back([member](SettingsType& settings, const std::string& text){
+                return Codecs::DecodeText(text, settings.*member);
+            });
+            return *this;
+        }
+
+        /**
+         * @brief Fetch all bound items in one round trip and publish a new snapshot.
+         * @retval true All existing items are parsed.
+         * @retval false Some items are invalid, they keep their values in the previous snapshot.
+         */
+        bool Load()
+        {
+            std::unique_lock lock(LoadMutex);
+            auto values = Configurator.GetItems(ItemNames);
+            auto settings = std::make_shared<SettingsType>(*std::atomic_load(&Current));
+            InvalidItems.clear();
+            for (std::size_t index = 0; index < ItemNames.size() && index < values.size(); ++index)
+            {
+                if (!values[index].has_value()) continue;
+                if (!ItemParsers[index](*settings, *values[index]))
+                {
+                    InvalidItems.push_back(ItemNames[index]);
+                }
+            }
+            std::atomic_store(&Current, Snapshot(std::move(settings)));
+            return InvalidItems.empty();
+        }
+
+        /// Get the current snapshot, it stays valid and unchanged while it is held.
+        [[nodiscard]] Snapshot Get() const noexcept
+        {
+            return std::atomic_load(&Current);
+        }
+
+        /// Get names of the items which failed to be parsed in the last load.
+        [[nodiscard]] std::vector<std::string> GetInvalidItems()
+        {
+            std::unique_lock lock(LoadMutex);
+            return InvalidItems;
+        }
+
+        /**
+         * @brief Reload the profile if the notification concerns the bound unit.
+         * @param channel Channel of the notification, ConfigurationClient::LoadChannel or UpdateChannel.
+         * @param message Content of the notification.
+         * @details
+         *  Load requests are published before the unit is written, so the profile is reloaded
+         *  by the update notice of the unit, or after ConfigurationClient::ReloadTimeout if it never arrives.
+         */
+        void HandleNotification(const std::string& channel, const std::string& message)
+        {
+            const auto& unit_name = Configurator.GetUnitName();
+            bool is_whole_unit = message.empty() || message == unit_name;
+            if (channel == ConfigurationClient::LoadChannel)
+            {
+                if (!is_whole_unit) return;
+                std::unique_lock lock(ReloadMutex);
+                ReloadDeadline = std::chrono::steady_clock::now() + ConfigurationClient::ReloadTimeout;
+                lock.unlock();
+                if (!ReloaderRunning.exchange(true)) Reloader.Start();
+                return;
+            }
+            if (channel != ConfigurationClient::UpdateChannel) return;
+            if (is_whole_unit)
+            {
+                std::unique_lock lock(ReloadMutex);
+                ReloadDeadline.reset();
+                lock.unlock();
+                Load();
+                return;
+            }
+            if (message.size() > unit_name.size() &&
+                message.compare(0, unit_name.size(), unit_name) == 0 && message[unit_name.size()] == '/')
+            {
+                Load();
+            }
+        }
+    };
+}
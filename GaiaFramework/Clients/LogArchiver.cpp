@@ -0,0 +1,157 @@
+#include "LogArchiver.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include <zlib.h>
+
+namespace Gaia::Framework::Clients
+{
+    /// Start the background archiver.
+    LogArchiver::LogArchiver(const std::string& directory, const std::string& prefix,
+                             const std::string& active_file, bool compress, std::uint64_t retention_bytes) :
+        Compress(compress), RetentionBytes(retention_bytes),
+        Archiver([this](const std::atomic_bool& life_flag){
+            this->ArchivePendingFiles(life_flag);
+        })
+    {
+        // Log files left by previous runs are also counted in the retention, from the oldest to the newest.
+        if (!prefix.empty())
+        {
+            std::vector<std::pair<std::filesystem::file_time_type, std::string>> existing_files;
+            std::error_code error;
+            for (const auto& entry : std::filesystem::directory_iterator(
+                    directory.empty() ? "." : directory, error))
+            {
+                auto file_name = entry.path().filename().string();
+                bool is_log_file = entry.path().extension() == ".log" ||
+                        (entry.path().extension() == ".gz" && entry.path().stem().extension() == ".log");
+                if (!is_log_file || file_name.compare(0, prefix.size(), prefix) != 0) continue;
+                if (!active_file.empty() && std::filesystem::equivalent(entry.path(), active_file, error)) continue;
+                existing_files.emplace_back(entry.last_write_time(error), entry.path().string());
+            }
+            std::sort(existing_files.begin(), existing_files.end());
+            for (auto& [time, path] : existing_files)
+            {
+                ArchivedFiles.push_back(std::move(path));
+            }
+        }
+        Archiver.Start();
+    }
+
+    /// Archive the remaining files and stop the background archiver.
+    LogArchiver::~LogArchiver()
+    {
+        ArchiveCondition.notify_one();
+        Archiver.Stop();
+    }
+
+    /// Add a closed log file to archive.
+    void LogArchiver::Archive(std::string path)
+    {
+        std::unique_lock lock(ArchiveMutex);
+        PendingFiles.push_back(std::move(path));
+        lock.unlock();
+        ArchiveCondition.notify_one();
+    }
+
+    /// Compress the given file into "<file>.gz" and remove the original file.
+    std::string LogArchiver::CompressFile(const std::string& path)
+    {
+        std::ifstream source(path, std::ios::binary);
+        if (!source.is_open()) return path;
+        auto archive_path = path + ".gz";
+        auto* archive = gzopen(archive_path.c_str(), "wb6");
+        if (!archive)
+        {
+            std::cout << "Failed to create log archive " << archive_path << std::endl;
+            return path;
+        }
+
+        std::vector<char> buffer(256 * 1024);
+        bool succeeded = true;
+        while (source && succeeded)
+        {
+            source.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            auto read_size = static_cast<unsigned int>(source.gcount());
+            if (read_size > 0)
+            {
+                succeeded = gzwrite(archive, buffer.data(), read_size) == static_cast<int>(read_size);
+            }
+        }
+        succeeded = gzclose(archive) == Z_OK && succeeded;
+        source.close();
+
+        std::error_code error;
+        if (!succeeded)
+        {
+            std::cout << "Failed to compress log file " << path << std::endl;
+            std::filesystem::remove(archive_path, error);
+            return path;
+        }
+        std::filesystem::remove(path, error);
+        return archive_path;
+    }
+
+    /// Remove the oldest archived files until their total size is under the retention limit.
+    void LogArchiver::ApplyRetention()
+    {
+        if (RetentionBytes == 0) return;
+
+        std::error_code error;
+        std::uint64_t total_size = 0;
+        for (auto iterator = ArchivedFiles.begin(); iterator != ArchivedFiles.end();)
+        {
+            auto file_size = std::filesystem::file_size(*iterator, error);
+            if (error)
+            {
+                // The file has been removed by others.
+                iterator = ArchivedFiles.erase(iterator);
+                continue;
+            }
+            total_size += file_size;
+            ++iterator;
+        }
+        while (total_size > RetentionBytes && !ArchivedFiles.empty())
+        {
+            auto file_size = std::filesystem::file_size(ArchivedFiles.front(), error);
+            if (!error)
+            {
+                total_size -= std::min(total_size, static_cast<std::uint64_t>(file_size));
+            }
+            std::filesystem::remove(ArchivedFiles.front(), error);
+            ArchivedFiles.pop_front();
+        }
+    }
+
+    /// Archive pending files until the life flag is false.
+    void LogArchiver::ArchivePendingFiles(const std::atomic_bool& life_flag)
+    {
+        while (true)
+        {
+            std::unique_lock lock(ArchiveMutex);
+            ArchiveCondition.wait_for(lock, std::chrono::milliseconds(100), [this, &life_flag]{
+                return !PendingFiles.empty() || !life_flag.load();
+            });
+            if (PendingFiles.empty())
+            {
+                if (!life_flag.load()) break;
+                continue;
+            }
+            auto path = std::move(PendingFiles.front());
+            PendingFiles.pop_front();
+            lock.unlock();
+
+            if (Compress)
+            {
+                path = CompressFile(path);
+            }
+
+            lock.lock();
+            ArchivedFiles.push_back(std::move(path));
+            ApplyRetention();
+        }
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <condition_variable>
+#include <GaiaBackground/GaiaBackground.hpp>
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Archiver which compresses closed log files and removes old ones on a background thread.
+     * @details
+     *  Closed log files are compressed into "<file>.gz" with zlib and the original files are removed,
+     *  then the oldest archived files are removed until their total size is under the retention limit.
+     */
+    class LogArchiver
+    {
+    private:
+        /// Whether closed files will be compressed or not.
+        const bool Compress;
+        /// Maximum total size of archived files in bytes, 0 means unlimited.
+        const std::uint64_t RetentionBytes;
+
+        /// Mutex for the pending files and archived files.
+        std::mutex ArchiveMutex;
+        /// Notified when a closed file is added.
+        std::condition_variable ArchiveCondition;
+        /// Closed files waiting to be archived.
+        std::deque<std::string> PendingFiles;
+        /// Archived files from the oldest to the newest.
+        std::list<std::string> ArchivedFiles;
+
+        /**
+         * @brief Compress the given file into "<file>.gz" and remove the original file.
+         * @return Path of the archived file, which is the original file if the compression failed.
+         */
+        static std::string CompressFile(const std::string& path);
+        /// Remove the oldest archived files until their total size is under the retention limit.
+        void ApplyRetention();
+        /// Archive pending files until the life flag is false, then archive the remaining ones.
+        void ArchivePendingFiles(const std::atomic_bool& life_flag);
+
+        /// Background worker which archives the pending files.
+        Gaia::Background::BackgroundWorker Archiver;
+
+    public:
+        /**
+         * @brief Start the background archiver.
+         * @param directory Directory of the log files.
+         * @param prefix Existing files with this prefix and a log file extension are counted in the retention,
+         *               ignored if it is empty.
+         * @param active_file The log file in use, which will never be counted or removed.
+         * @param compress Whether closed files will be compressed or not.
+         * @param retention_bytes Maximum total size of archived files in bytes, 0 means unlimited.
+         */
+        LogArchiver(const std::string& directory, const std::string& prefix, const std::string& active_file,
+                    bool compress, std::uint64_t retention_bytes);
+        /// Archive the remaining files and stop the background archiver.
+        ~LogArchiver();
+
+        /// Add a closed log file to archive, it will be compressed on the background thread.
+        void Archive(std::string path);
+    };
+}
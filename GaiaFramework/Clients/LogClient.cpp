@@ -2,6 +2,9 @@
 
 #include <iostream>
 #include <utility>
+#include <algorithm>
+#include <iterator>
+#include <thread>
 
 #ifndef LOG_SERVICE_CHANNEL
 #define LOG_SERVICE_CHANNEL "logs/record"
@@ -11,7 +14,16 @@ namespace Gaia::Framework::Clients
 {
     /// Try to connect to the Redis server, and it will use a local file instead if failed.
     LogClient::LogClient(std::string author, unsigned int port, const std::string &ip) :
-        Author(std::move(author))
+        Author(std::move(author)),
+        Publisher([this](const std::atomic_bool& life_flag){
+            this->PublishQueuedLogs(life_flag);
+        }),
+        Recoverer([this](const std::atomic_bool& life_flag){
+            this->RecoverSpilledLogs(life_flag);
+        }),
+        ThrottleSweeper([this](const std::atomic_bool& life_flag){
+            this->SweepThrottle(life_flag);
+        })
     {
         try
         {
@@ -24,7 +36,6 @@ namespace Gaia::Framework::Clients
             }
         }catch (std::exception& error)
         {
-            Connection.reset();
             SwitchToOfflineMode("No log service detected.");
         }
     }
@@ -32,11 +43,21 @@ namespace Gaia::Framework::Clients
     /// Reuse the connection to a Redis server.
     /// Reuse the connection to a Redis server.
     LogClient::LogClient(std::string author, std::shared_ptr<sw::redis::Redis> connection) :
-        Author(std::move(author)), Connection(std::move(connection))
+        Author(std::move(author)), Connection(std::move(connection)),
+        Publisher([this](const std::atomic_bool& life_flag){
+            this->PublishQueuedLogs(life_flag);
+        }),
+        Recoverer([this](const std::atomic_bool& life_flag){
+            this->RecoverSpilledLogs(life_flag);
+        }),
+        ThrottleSweeper([this](const std::atomic_bool& life_flag){
+            this->SweepThrottle(life_flag);
+        })
     {
         if (!Connection)
         {
-            Logger = std::make_unique<LogRecorder>(Author);
+            SwitchToOfflineMode();
+            return;
         }
 
         try
@@ -49,21 +70,86 @@ namespace Gaia::Framework::Clients
             }
         }catch (std::exception& error)
         {
-            Connection.reset();
             SwitchToOfflineMode("No log service detected.");
         }
     }
 
+    /// Record summaries of suppressed logs, stop the asynchronous publisher and the recoverer,
+    /// then publish the remaining logs.
+    LogClient::~LogClient()
+    {
+        if (Throttle)
+        {
+            ThrottleSweeper.Stop();
+            std::vector<LogThrottle::Summary> summaries;
+            Throttle->Flush(summaries);
+            RecordSummaries(summaries);
+        }
+        DisableAsyncMode();
+        if (Spill)
+        {
+            Recoverer.Stop();
+        }
+    }
+
+    /// Queue a log for the publisher.
+    bool LogClient::QueueText(const std::string& text)
+    {
+        std::unique_lock lock(QueueMutex);
+        // The publisher takes its last batch under the lock after the mode is cleared, so it is checked here.
+        if (!AsyncMode) return false;
+        if (Queue.size() >= QueueCapacity && QueueOverflowPolicy == OverflowPolicy::Block)
+        {
+            QueueDrainedCondition.wait(lock, [this]{
+                return Queue.size() < QueueCapacity || !AsyncMode;
+            });
+            if (!AsyncMode) return false;
+        }
+        if (Queue.size() < QueueCapacity)
+        {
+            Queue.push_back(text);
+            if (Queue.size() >= BatchSize)
+            {
+                QueueFilledCondition.notify_one();
+            }
+        }
+        else
+        {
+            ++DroppedCount;
+        }
+        return true;
+    }
+
     /// Record a raw text into the log.
     void LogClient::RecordRawText(const std::string& text)
     {
-        if (Connection)
+        // The connection may be swapped by other threads, so it is loaded once.
+        auto connection = std::atomic_load(&Connection);
+        if (connection && AsyncMode && QueueText(text))
+        {}
+        else if (connection)
         {
-            Connection->publish(LOG_SERVICE_CHANNEL, text);
+            try
+            {
+                connection->publish(LOG_SERVICE_CHANNEL, text);
+            }
+            catch (sw::redis::Error& error)
+            {
+                if (!Spill) throw;
+                // The text may be the formatting buffer, which will be reused by the milestone of switching.
+                std::string lost_text(text);
+                SwitchToOfflineMode("Log service connection lost.");
+                std::atomic_load(&Logger)->RecordRawText(lost_text);
+                Spill->Append(lost_text);
+            }
         }
-        else if (Logger)
+        else if (auto logger = std::atomic_load(&Logger))
         {
-            Logger->RecordRawText(text);
+            logger->RecordRawText(text);
+            if (Spill)
+            {
+                Spill->Append(text);
+            }
         }
 
         if (PrintToConsole)
@@ -72,56 +158,407 @@ namespace Gaia::Framework::Clients
         }
     }
 
+    /// Publish queued logs in batches until the life flag is false.
+    void LogClient::PublishQueuedLogs(const std::atomic_bool& life_flag)
+    {
+        std::unique_ptr<sw::redis::Pipeline> pipeline;
+        std::deque<std::string> batch;
+
+        while (life_flag.load())
+        {
+            std::unique_lock lock(QueueMutex);
+            QueueFilledCondition.wait_for(lock, BatchInterval, [this, &life_flag]{
+                return Queue.size() >= BatchSize || !life_flag.load();
+            });
+            auto batch_end = Queue.begin() + static_cast<long>(std::min(Queue.size(), BatchSize));
+            batch.assign(std::make_move_iterator(Queue.begin()), std::make_move_iterator(batch_end));
+            Queue.erase(Queue.begin(), batch_end);
+            lock.unlock();
+            QueueDrainedCondition.notify_all();
+
+            PublishBatch(pipeline, batch);
+        }
+
+        // Publish the remaining logs in the queue.
+        std::unique_lock lock(QueueMutex);
+        batch.swap(Queue);
+        lock.unlock();
+        QueueDrainedCondition.notify_all();
+        while (!batch.empty())
+        {
+            std::deque<std::string> remaining;
+            if (batch.size() > BatchSize)
+            {
+                remaining.assign(std::make_move_iterator(batch.begin() + static_cast<long>(BatchSize)),
+                                 std::make_move_iterator(batch.end()));
+                batch.resize(BatchSize);
+            }
+            PublishBatch(pipeline, batch);
+            batch.swap(remaining);
+        }
+    }
+
+    /// Publish the given logs in one pipeline.
+    void LogClient::PublishBatch(std::unique_ptr<sw::redis::Pipeline>& pipeline, std::deque<std::string>& batch)
+    {
+        if (batch.empty()) return;
+
+        auto connection = std::atomic_load(&Connection);
+        if (!connection)
+        {
+            if (auto logger = std::atomic_load(&Logger))
+            {
+                for (const auto& text : batch)
+                {
+                    logger->RecordRawText(text);
+                }
+            }
+            batch.clear();
+            return;
+        }
+
+        try
+        {
+            if (!pipeline)
+            {
+                pipeline = std::make_unique<sw::redis::Pipeline>(connection->pipeline());
+            }
+            for (const auto& text : batch)
+            {
+                pipeline->publish(LOG_SERVICE_CHANNEL, text);
+            }
+            pipeline->exec();
+        }
+        catch (sw::redis::Error& error)
+        {
+            // The pipeline connection may be broken, it will be recreated for the next batch.
+            pipeline.reset();
+            if (Spill)
+            {
+                for (const auto& text : batch)
+                {
+                    Spill->Append(text);
+                }
+            }
+            else
+            {
+                DroppedCount += batch.size();
+            }
+        }
+        batch.clear();
+    }
+
+    /// Queue logs in memory and publish them in batches on a background thread.
+    void LogClient::EnableAsyncMode(std::size_t capacity, std::size_t batch_size,
+                                    std::chrono::milliseconds interval, OverflowPolicy policy)
+    {
+        DisableAsyncMode();
+
+        std::unique_lock lock(QueueMutex);
+        QueueCapacity = std::max<std::size_t>(capacity, 1);
+        BatchSize = std::max<std::size_t>(batch_size, 1);
+        BatchInterval = interval;
+        QueueOverflowPolicy = policy;
+        lock.unlock();
+
+        AsyncMode = true;
+        Publisher.Start();
+    }
+
+    /// Stop the asynchronous publisher and publish the remaining logs.
+    void LogClient::DisableAsyncMode()
+    {
+        // Cleared under the lock, so producers which still see the mode queue before the last batch is taken.
+        std::unique_lock lock(QueueMutex);
+        bool was_async = AsyncMode.exchange(false);
+        lock.unlock();
+        if (!was_async) return;
+        QueueDrainedCondition.notify_all();
+        QueueFilledCondition.notify_all();
+        Publisher.Stop();
+    }
+
+    /// Record a log with the given severity and text.
+    void LogClient::RecordText(LogSeverity severity, std::string_view text)
+    {
+        auto logger = std::atomic_load(&Logger);
+        if (!std::atomic_load(&Connection) && logger && logger->IsBinaryMode())
+        {
+            logger->Record(text, severity, Author);
+            if (Spill)
+            {
+                Spill->Append(LogFormatter::Format(severity, Author, text));
+            }
+            if (PrintToConsole && !logger->PrintToConsole)
+            {
+                std::cout << LogFormatter::Format(severity, Author, text) << std::endl;
+            }
+            return;
+        }
+        RecordRawText(LogFormatter::Format(severity, Author, text));
+    }
+
+    /// Record a log through the throttle, with the template to group repeated logs.
+    void LogClient::RecordThrottledText(LogSeverity severity, std::string_view template_text, std::string_view text)
+    {
+        std::vector<LogThrottle::Summary> summaries;
+        bool unique = Throttle->Deduplicate(severity, template_text, text, summaries);
+        RecordSummaries(summaries);
+        if (unique)
+        {
+            RecordText(severity, text);
+        }
+    }
+
+    /// Record the given summaries of suppressed logs.
+    void LogClient::RecordSummaries(const std::vector<LogThrottle::Summary>& summaries)
+    {
+        for (const auto& summary : summaries)
+        {
+            RecordText(summary.Severity, summary.Text);
+        }
+    }
+
+    /// Record summaries of expired deduplication windows regularly until the life flag is false.
+    void LogClient::SweepThrottle(const std::atomic_bool& life_flag)
+    {
+        std::vector<LogThrottle::Summary> summaries;
+        while (life_flag.load())
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            Throttle->Sweep(summaries);
+            RecordSummaries(summaries);
+            summaries.clear();
+        }
+    }
+
+    /// Rate limit and deduplicate repeated logs.
+    void LogClient::EnableThrottle(const LogThrottle::Options& options)
+    {
+        if (Throttle)
+        {
+            ThrottleSweeper.Stop();
+        }
+        Throttle = std::make_unique<LogThrottle>(options);
+        ThrottleSweeper.Start();
+    }
+
+    /// Get suppression counts of log groups which have suppressed any log.
+    std::vector<LogThrottle::Suppression> LogClient::GetSuppressions() const
+    {
+        if (!Throttle) return {};
+        return Throttle->GetSuppressions();
+    }
+
     /// Record a message log.
     void LogClient::RecordMessage(const std::string& text)
     {
-        RecordRawText(LogRecorder::GenerateLogText(text, LogRecorder::Severity::Message, Author));
+        if (!IsEnabled(LogSeverity::Message)) return;
+        if (Throttle)
+        {
+            if (!Throttle->Acquire(LogSeverity::Message, text)) return;
+            RecordThrottledText(LogSeverity::Message, text, text);
+            return;
+        }
+        RecordText(LogSeverity::Message, text);
     }
 
     /// Record a milestone log.
     void LogClient::RecordMilestone(const std::string& text)
     {
-        RecordRawText(LogRecorder::GenerateLogText(text, LogRecorder::Severity::Milestone, Author));
+        if (!IsEnabled(LogSeverity::Milestone)) return;
+        if (Throttle)
+        {
+            if (!Throttle->Acquire(LogSeverity::Milestone, text)) return;
+            RecordThrottledText(LogSeverity::Milestone, text, text);
+            return;
+        }
+        RecordText(LogSeverity::Milestone, text);
     }
 
     /// Record a warning log.
     void LogClient::RecordWarning(const std::string& text)
     {
-        RecordRawText(LogRecorder::GenerateLogText(text, LogRecorder::Severity::Warning, Author));
+        if (!IsEnabled(LogSeverity::Warning)) return;
+        if (Throttle)
+        {
+            if (!Throttle->Acquire(LogSeverity::Warning, text)) return;
+            RecordThrottledText(LogSeverity::Warning, text, text);
+            return;
+        }
+        RecordText(LogSeverity::Warning, text);
     }
 
     /// Record an error log.
     void LogClient::RecordError(const std::string& text)
     {
-        RecordRawText(LogRecorder::GenerateLogText(text, LogRecorder::Severity::Error, Author));
+        if (!IsEnabled(LogSeverity::Error)) return;
+        if (Throttle)
+        {
+            if (!Throttle->Acquire(LogSeverity::Error, text)) return;
+            RecordThrottledText(LogSeverity::Error, text, text);
+            return;
+        }
+        RecordText(LogSeverity::Error, text);
     }
 
     /// Switch to offline mode.
     void LogClient::SwitchToOfflineMode(const std::string& reason)
     {
-        if (Connection) Connection.reset();
-        if (!Logger)
+        // Publishes of several threads may fail at the same time, only the first one switches.
+        std::unique_lock lock(OfflineMutex);
+        auto connection = std::atomic_exchange(&Connection, std::shared_ptr<sw::redis::Redis>());
+        if (connection)
+        {
+            // The connection is kept to probe whether the log service is back or not.
+            std::atomic_store(&StandbyConnection, std::move(connection));
+        }
+        else if (std::atomic_load(&Logger))
         {
-            Logger = std::make_unique<LogRecorder>(Author);
-            Logger->PrintToConsole = PrintToConsole;
-            if (reason.empty())
+            return;
+        }
+        if (!std::atomic_load(&Logger))
+        {
+            auto logger = std::make_shared<LogRecorder>(Author);
+            logger->PrintToConsole = PrintToConsole;
+            if (!OfflineSegmentDirectory.empty())
             {
-                RecordMilestone("Switch to offline log mode.");
+                logger->EnableBinarySegments(OfflineSegmentDirectory, OfflineSegmentSize);
             }
-            else
+            if (OfflineRotation)
             {
-                RecordMilestone("Switch to offline log mode, reason: " + reason);
+                logger->EnableRotation(*OfflineRotation);
             }
+            std::atomic_store(&Logger, std::move(logger));
+        }
+        lock.unlock();
+
+        if (reason.empty())
+        {
+            RecordMilestone("Switch to offline log mode.");
+        }
+        else
+        {
+            RecordMilestone("Switch to offline log mode, reason: " + reason);
+        }
+    }
+
+    /// Spill logs which could not be published to a local file and replay them when the log service is back.
+    void LogClient::EnableSpillRecovery(const std::string& path, std::chrono::milliseconds probe_interval,
+                                        std::size_t replay_rate, std::size_t replay_batch_size)
+    {
+        if (Spill)
+        {
+            Recoverer.Stop();
+        }
+        ProbeInterval = probe_interval;
+        ReplayRate = replay_rate;
+        ReplayBatchSize = std::max<std::size_t>(replay_batch_size, 1);
+        Spill = std::make_unique<LogSpill>(path);
+        Recoverer.Start();
+    }
+
+    /// Replay spilled logs through the given connection.
+    bool LogClient::ReplaySpilledLogs(sw::redis::Redis& connection, const std::atomic_bool& life_flag)
+    {
+        try
+        {
+            auto pipeline = connection.pipeline();
+            return Spill->Replay([&pipeline](const std::vector<std::string>& texts){
+                for (const auto& text : texts)
+                {
+                    pipeline.publish(LOG_SERVICE_CHANNEL, text);
+                }
+                pipeline.exec();
+            }, ReplayBatchSize, ReplayRate, life_flag);
+        }
+        catch (sw::redis::Error& error)
+        {
+            return false;
+        }
+    }
+
+    /// Probe the log service and replay spilled logs until the life flag is false.
+    void LogClient::RecoverSpilledLogs(const std::atomic_bool& life_flag)
+    {
+        while (life_flag.load())
+        {
+            auto probe_time = std::chrono::steady_clock::now() + ProbeInterval;
+            while (life_flag.load() && std::chrono::steady_clock::now() < probe_time)
+            {
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                        std::chrono::milliseconds(100), probe_time - std::chrono::steady_clock::now()));
+            }
+            if (!life_flag.load()) break;
+
+            // Logs spilled by a failed asynchronous batch are replayed through the current connection.
+            if (auto connection = std::atomic_load(&Connection))
+            {
+                if (Spill->HasPending())
+                {
+                    ReplaySpilledLogs(*connection, life_flag);
+                }
+                continue;
+            }
+
+            auto connection = std::atomic_load(&StandbyConnection);
+            if (!connection) continue;
+            try
+            {
+                if (connection->publish(LOG_SERVICE_CHANNEL,
+                                        LogRecorder::GenerateLogText("Log service client reconnected.",
+                                                                     LogRecorder::Severity::Milestone, Author)) < 1)
+                {
+                    continue;
+                }
+            }
+            catch (sw::redis::Error& error)
+            {
+                continue;
+            }
+
+            // The snapshot of spilled logs is replayed before new logs are published,
+            // logs spilled meanwhile are replayed through the restored connection by the next probes.
+            if (ReplaySpilledLogs(*connection, life_flag))
+            {
+                std::atomic_store(&Connection, connection);
+                std::atomic_store(&StandbyConnection, std::shared_ptr<sw::redis::Redis>());
+            }
+        }
+    }
+
+    /// Write logs into memory-mapped binary segment files in offline mode.
+    void LogClient::EnableOfflineSegments(const std::string& directory, std::uint64_t segment_size)
+    {
+        std::unique_lock lock(OfflineMutex);
+        OfflineSegmentDirectory = directory;
+        OfflineSegmentSize = segment_size;
+        auto logger = std::atomic_load(&Logger);
+        if (logger && !logger->IsBinaryMode())
+        {
+            logger->EnableBinarySegments(OfflineSegmentDirectory, OfflineSegmentSize);
+        }
+    }
+
+    /// Rotate local log files by size and time in offline mode.
+    void LogClient::EnableOfflineRotation(const LogRecorder::RotationOptions& options)
+    {
+        std::unique_lock lock(OfflineMutex);
+        OfflineRotation = std::make_unique<LogRecorder::RotationOptions>(options);
+        if (auto logger = std::atomic_load(&Logger))
+        {
+            logger->EnableRotation(options);
         }
     }
 
     /// Set whether auto print logs to console or not.
     void LogClient::SetPrintToConsole(bool enable)
     {
+        std::unique_lock lock(OfflineMutex);
         PrintToConsole = enable;
-        if (Logger)
+        if (auto logger = std::atomic_load(&Logger))
         {
-            Logger->PrintToConsole = enable;
+            logger->PrintToConsole = enable;
         }
     }
 }
\ No newline at end of file
@@ -1,11 +1,22 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <memory>
 #include <fstream>
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <sw/redis++/redis++.h>
+#include <GaiaBackground/GaiaBackground.hpp>
 
 #include "LogRecorder.hpp"
+#include "LogFormatter.hpp"
+#include "LogSpill.hpp"
+#include "LogThrottle.hpp"
 
 namespace Gaia::Framework::Clients
 {
@@ -17,21 +28,113 @@ namespace Gaia::Framework::Clients
      */
     class LogClient
     {
+    public:
+        /// Policy to apply when the asynchronous log queue is full.
+        enum class OverflowPolicy
+        {
+            Drop = 0,   ///< Discard the new log and count it as dropped.
+            Block = 1   ///< Block the recording thread until the queue has free space.
+        };
+
     private:
-        /// Local file log recorder.
-        std::unique_ptr<LogRecorder> Logger;
-        /// Remote log service connection.
+        /// Local file log recorder, accessed with std::atomic_load() and std::atomic_store().
+        std::shared_ptr<LogRecorder> Logger;
+        /// Remote log service connection, accessed with std::atomic_load() and std::atomic_store().
         std::shared_ptr<sw::redis::Redis> Connection;
+        /// Connection kept in offline mode to probe whether the log service is back or not.
+        std::shared_ptr<sw::redis::Redis> StandbyConnection;
+        /// Mutex for switching to the offline mode and for the options of the local recorder.
+        std::mutex OfflineMutex;
 
         /// Record a raw text into the log.
         void RecordRawText(const std::string& text);
 
+        /// Logs below this severity will be discarded.
+        std::atomic<LogSeverity> MinimumSeverity {LogSeverity::Message};
+
+        /// Directory of binary log segments in offline mode, logs are written as text if it is empty.
+        std::string OfflineSegmentDirectory;
+        /// Size of every binary log segment file in offline mode.
+        std::uint64_t OfflineSegmentSize {64 * 1024 * 1024};
+
+        /// Options of log file rotation in offline mode, null if rotation is not enabled.
+        std::unique_ptr<LogRecorder::RotationOptions> OfflineRotation;
+
+        /// Record a log with the given severity and text.
+        void RecordText(LogSeverity severity, std::string_view text);
+
+        /// Rate limiter and deduplicator of repeated logs, null if throttling is not enabled.
+        std::unique_ptr<LogThrottle> Throttle;
+
+        /// Record a log through the throttle, with the template to group repeated logs.
+        void RecordThrottledText(LogSeverity severity, std::string_view template_text, std::string_view text);
+        /// Record the given summaries of suppressed logs.
+        void RecordSummaries(const std::vector<LogThrottle::Summary>& summaries);
+        /// Record summaries of expired deduplication windows regularly until the life flag is false.
+        void SweepThrottle(const std::atomic_bool& life_flag);
+
+        /// Check whether any log destination is available or not.
+        [[nodiscard]] inline bool HasDestination() const noexcept
+        {
+            return std::atomic_load(&Connection) || std::atomic_load(&Logger) || PrintToConsole;
+        }
+
         /// The author of the logs.
         std::string Author {"Anonymous"};
 
         /// Whether logs will be printed to the console or not.
         bool PrintToConsole {false};
 
+        /// Whether logs are queued and published by the background publisher or not.
+        std::atomic_bool AsyncMode {false};
+        /// Mutex for the asynchronous log queue.
+        std::mutex QueueMutex;
+        /// Notified when a batch of logs is ready to publish.
+        std::condition_variable QueueFilledCondition;
+        /// Notified when logs are taken out of the queue.
+        std::condition_variable QueueDrainedCondition;
+        /// Logs waiting to be published.
+        std::deque<std::string> Queue;
+        /// Maximum count of logs in the queue.
+        std::size_t QueueCapacity {4096};
+        /// Maximum count of logs to publish in one pipeline.
+        std::size_t BatchSize {128};
+        /// Maximum time a log can wait in the queue before it is published.
+        std::chrono::milliseconds BatchInterval {50};
+        /// Policy to apply when the queue is full.
+        OverflowPolicy QueueOverflowPolicy {OverflowPolicy::Drop};
+        /// Count of logs dropped because the queue was full or the publishing failed.
+        std::atomic<std::uint64_t> DroppedCount {0};
+
+        /// Queue a log for the publisher, returns false if the asynchronous mode has been disabled.
+        bool QueueText(const std::string& text);
+        /// Publish queued logs in batches until the life flag is false, then publish the remaining ones.
+        void PublishQueuedLogs(const std::atomic_bool& life_flag);
+        /// Publish the given logs in one pipeline.
+        void PublishBatch(std::unique_ptr<sw::redis::Pipeline>& pipeline, std::deque<std::string>& batch);
+
+        /// Background worker which publishes the queued logs.
+        Gaia::Background::BackgroundWorker Publisher;
+
+        /// Logs which could not be published, null if spill recovery is not enabled.
+        std::unique_ptr<LogSpill> Spill;
+        /// Interval between two probes of the log service in offline mode.
+        std::chrono::milliseconds ProbeInterval {5000};
+        /// Maximum count of spilled logs to replay per second.
+        std::size_t ReplayRate {1000};
+        /// Maximum count of spilled logs to replay in one pipeline.
+        std::size_t ReplayBatchSize {128};
+
+        /// Probe the log service and replay spilled logs until the life flag is false.
+        void RecoverSpilledLogs(const std::atomic_bool& life_flag);
+        /// Replay spilled logs through the given connection.
+        bool ReplaySpilledLogs(sw::redis::Redis& connection, const std::atomic_bool& life_flag);
+
+        /// Background worker which probes the log service and replays the spilled logs.
+        Gaia::Background::BackgroundWorker Recoverer;
+        /// Background worker which records summaries of suppressed logs when their groups stay quiet.
+        Gaia::Background::BackgroundWorker ThrottleSweeper;
+
     public:
         /**
          * @brief Set whether print the log to the console or not.
@@ -54,6 +157,117 @@ namespace Gaia::Framework::Clients
          */
         explicit LogClient(std::string author, std::shared_ptr<sw::redis::Redis> connection);
 
+        /// Record summaries of suppressed logs, stop the asynchronous publisher and the recoverer,
+        /// then publish the remaining logs.
+        ~LogClient();
+
+        /**
+         * @brief Queue logs in memory and publish them in batches on a background thread.
+         * @param capacity Maximum count of logs waiting in the queue.
+         * @param batch_size Maximum count of logs to publish in one pipeline.
+         * @param interval Maximum time a log can wait in the queue before it is published.
+         * @param policy Policy to apply when the queue is full.
+         * @details
+         *  Recording a log in this mode only costs a queue push.
+         *  Logs are published with pipelined PUBLISH commands when a batch is full or the interval is up.
+         *  Has no effect in offline mode.
+         */
+        void EnableAsyncMode(std::size_t capacity = 4096, std::size_t batch_size = 128,
+                             std::chrono::milliseconds interval = std::chrono::milliseconds(50),
+                             OverflowPolicy policy = OverflowPolicy::Drop);
+        /// Stop the asynchronous publisher and publish the remaining logs, then publish logs synchronously.
+        void DisableAsyncMode();
+        /// Check whether logs are published asynchronously or not.
+        [[nodiscard]] inline bool IsAsyncMode() const noexcept
+        {
+            return AsyncMode.load();
+        }
+        /// Get the count of logs dropped because the queue was full or the publishing failed.
+        [[nodiscard]] inline std::uint64_t GetDroppedCount() const noexcept
+        {
+            return DroppedCount.load();
+        }
+
+        /**
+         * @brief Set the minimum severity of logs to record.
+         * @details Logs below this severity will be discarded before their texts are generated.
+         */
+        inline void SetMinimumSeverity(LogSeverity severity) noexcept
+        {
+            MinimumSeverity = severity;
+        }
+        /// Get the minimum severity of logs to record.
+        [[nodiscard]] inline LogSeverity GetMinimumSeverity() const noexcept
+        {
+            return MinimumSeverity.load(std::memory_order_relaxed);
+        }
+        /**
+         * @brief Check whether logs of the given severity will be recorded or not.
+         * @details Use it to skip generating texts of logs which will be discarded.
+         */
+        [[nodiscard]] inline bool IsEnabled(LogSeverity severity) const noexcept
+        {
+            return IsSeverityCompiled(severity) &&
+                static_cast<int>(severity) >= static_cast<int>(MinimumSeverity.load(std::memory_order_relaxed));
+        }
+
+        /**
+         * @brief Write logs into memory-mapped binary segment files in offline mode.
+         * @param directory Directory to place segment files.
+         * @param segment_size Size of every preallocated segment file.
+         * @details Segment files can be queried by LogSegmentReader or the LogReader tool.
+         */
+        void EnableOfflineSegments(const std::string& directory, std::uint64_t segment_size = 64 * 1024 * 1024);
+
+        /**
+         * @brief Rotate local log files by size and time in offline mode.
+         * @param options Options of the rotation, closed files are compressed on a background thread.
+         */
+        void EnableOfflineRotation(const LogRecorder::RotationOptions& options);
+
+        /**
+         * @brief Spill logs which could not be published to a local file and replay them when the log service is back.
+         * @param path Path of the spill file, logs left by previous runs will also be replayed.
+         * @param probe_interval Interval between two probes of the log service in offline mode.
+         * @param replay_rate Maximum count of spilled logs to replay per second, 0 means unlimited.
+         * @param replay_batch_size Maximum count of spilled logs to replay in one pipeline.
+         * @details
+         *  Once the log service answers a probe, spilled logs are replayed in order with pipelined PUBLISH
+         *  commands, then this client switches back to the online mode.
+         *  Logs are replayed at least once, a batch interrupted by a failure will be replayed again.
+         */
+        void EnableSpillRecovery(const std::string& path,
+                                 std::chrono::milliseconds probe_interval = std::chrono::milliseconds(5000),
+                                 std::size_t replay_rate = 1000, std::size_t replay_batch_size = 128);
+        /// Get the count of logs spilled to the local file.
+        [[nodiscard]] inline std::uint64_t GetSpilledCount() const noexcept
+        {
+            return Spill ? Spill->GetSpilledCount() : 0;
+        }
+
+        /**
+         * @brief Rate limit and deduplicate repeated logs.
+         * @param options Options of the token buckets and the deduplication window.
+         * @details
+         *  Logs are grouped by their severities and templates, which are the format texts of formatted logs.
+         *  Logs beyond the rate of their group are discarded before their texts are generated,
+         *  and identical logs within the deduplication window are collapsed into "repeated N times" summaries.
+         *  Summaries are recorded by a background worker shortly after their windows expire.
+         */
+        void EnableThrottle(const LogThrottle::Options& options);
+        /// Get the count of identical logs collapsed by the deduplication.
+        [[nodiscard]] inline std::uint64_t GetDuplicateCount() const noexcept
+        {
+            return Throttle ? Throttle->GetDuplicateCount() : 0;
+        }
+        /// Get the count of logs suppressed by the rate limit.
+        [[nodiscard]] inline std::uint64_t GetRateLimitedCount() const noexcept
+        {
+            return Throttle ? Throttle->GetRateLimitedCount() : 0;
+        }
+        /// Get suppression counts of log groups which have suppressed any log.
+        [[nodiscard]] std::vector<LogThrottle::Suppression> GetSuppressions() const;
+
         /// Switch to the offline mode, will use a local log file.
         void SwitchToOfflineMode(const std::string& reason = "");
 
@@ -81,5 +295,102 @@ namespace Gaia::Framework::Clients
          * @details Error log represents the abnormal situation of a program.
          */
         void RecordError(const std::string& text);
+
+        /**
+         * @brief Record a log whose text is formatted from the given format and arguments.
+         * @param severity Severity of the log.
+         * @param format Format text, every "{}" will be replaced with the next argument.
+         * @param arguments Arguments to render into the text.
+         * @details Arguments are only rendered when the log is enabled and will be recorded somewhere.
+         */
+        template <typename... ArgumentTypes>
+        void RecordFormat(LogSeverity severity, std::string_view format, const ArgumentTypes&... arguments)
+        {
+            if (!IsEnabled(severity) || !HasDestination()) return;
+            if (Throttle)
+            {
+                if (!Throttle->Acquire(severity, format)) return;
+                RecordThrottledText(severity, format, LogFormatter::FormatText(format, arguments...));
+                return;
+            }
+            RecordText(severity, LogFormatter::FormatText(format, arguments...));
+        }
+
+        /// Record a message log formatted from the format text and arguments.
+        template <typename... ArgumentTypes>
+        std::enable_if_t<(sizeof...(ArgumentTypes) > 0)>
+        RecordMessage(std::string_view format, const ArgumentTypes&... arguments)
+        {
+            RecordFormat(LogSeverity::Message, format, arguments...);
+        }
+        /// Record a milestone log formatted from the format text and arguments.
+        template <typename... ArgumentTypes>
+        std::enable_if_t<(sizeof...(ArgumentTypes) > 0)>
+        RecordMilestone(std::string_view format, const ArgumentTypes&... arguments)
+        {
+            RecordFormat(LogSeverity::Milestone, format, arguments...);
+        }
+        /// Record a warning log formatted from the format text and arguments.
+        template <typename... ArgumentTypes>
+        std::enable_if_t<(sizeof...(ArgumentTypes) > 0)>
+        RecordWarning(std::string_view format, const ArgumentTypes&... arguments)
+        {
+            RecordFormat(LogSeverity::Warning, format, arguments...);
+        }
+        /// Record an error log formatted from the format text and arguments.
+        template <typename... ArgumentTypes>
+        std::enable_if_t<(sizeof...(ArgumentTypes) > 0)>
+        RecordError(std::string_view format, const ArgumentTypes&... arguments)
+        {
+            RecordFormat(LogSeverity::Error, format, arguments...);
+        }
+
+        /**
+         * @brief Record a log whose text is generated by the given functor.
+         * @param severity Severity of the log.
+         * @param generator Functor which returns the text of the log.
+         * @details The functor is only invoked when the log is enabled and will be recorded somewhere.
+         */
+        template <typename GeneratorType>
+        std::enable_if_t<std::is_invocable_v<GeneratorType&>>
+        RecordLazy(LogSeverity severity, GeneratorType&& generator)
+        {
+            if (!IsEnabled(severity) || !HasDestination()) return;
+            if (Throttle)
+            {
+                // Lazy logs have no template, they are grouped by their texts.
+                std::string text(generator());
+                if (!Throttle->Acquire(severity, text)) return;
+                RecordThrottledText(severity, text, text);
+                return;
+            }
+            RecordText(severity, generator());
+        }
     };
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Record a log if its severity is enabled, arguments are not evaluated otherwise.
+ * @details
+ *  Usage: GAIA_LOG(GetLogger(), Gaia::Framework::Clients::LogSeverity::Warning, "Value {} is invalid.", value);
+ *  Logs below GAIA_LOG_MINIMUM_SEVERITY are removed at compile time.
+ */
+#ifndef GAIA_LOG
+#define GAIA_LOG(logger, severity, ...) \
+    do { \
+        if (::Gaia::Framework::Clients::IsSeverityCompiled(severity) && (logger)->IsEnabled(severity)) \
+            (logger)->RecordFormat((severity), __VA_ARGS__); \
+    } while (false)
+#endif
+#ifndef GAIA_LOG_MESSAGE
+#define GAIA_LOG_MESSAGE(logger, ...) GAIA_LOG(logger, ::Gaia::Framework::Clients::LogSeverity::Message, __VA_ARGS__)
+#endif
+#ifndef GAIA_LOG_MILESTONE
+#define GAIA_LOG_MILESTONE(logger, ...) GAIA_LOG(logger, ::Gaia::Framework::Clients::LogSeverity::Milestone, __VA_ARGS__)
+#endif
+#ifndef GAIA_LOG_WARNING
+#define GAIA_LOG_WARNING(logger, ...) GAIA_LOG(logger, ::Gaia::Framework::Clients::LogSeverity::Warning, __VA_ARGS__)
+#endif
+#ifndef GAIA_LOG_ERROR
+#define GAIA_LOG_ERROR(logger, ...) GAIA_LOG(logger, ::Gaia::Framework::Clients::LogSeverity::Error, __VA_ARGS__)
+#endif
\ No newline at end of file
@@ -0,0 +1,149 @@
+#include "LogFormatter.hpp"
+
+#include <ctime>
+#include <cctype>
+
+namespace Gaia::Framework::Clients
+{
+    /// Get the reused log line buffer of the current thread.
+    std::string& LogFormatter::GetBuffer()
+    {
+        thread_local std::string buffer;
+        buffer.clear();
+        return buffer;
+    }
+
+    /// Get the reused log text buffer of the current thread.
+    std::string& LogFormatter::GetTextBuffer()
+    {
+        thread_local std::string buffer;
+        buffer.clear();
+        return buffer;
+    }
+
+    /// Append the local time text of the given time point.
+    void LogFormatter::AppendTimestamp(std::string& buffer, std::chrono::system_clock::time_point time_point)
+    {
+        thread_local std::time_t cached_second = -1;
+        thread_local char cached_text[8];
+
+        auto milliseconds = std::chrono::duration_cast<std::chrono::milliseconds>(
+                time_point.time_since_epoch()).count();
+        auto millisecond = static_cast<int>(milliseconds % 1000);
+        auto global_time = static_cast<std::time_t>(milliseconds / 1000);
+        if (millisecond < 0)
+        {
+            millisecond += 1000;
+            global_time -= 1;
+        }
+
+        if (global_time != cached_second)
+        {
+            std::tm local_time {};
+            #ifdef _WIN32
+            localtime_s(&local_time, &global_time);
+            #else
+            localtime_r(&global_time, &local_time);
+            #endif
+            auto write_two_digits = [](char* destination, int value){
+                destination[0] = static_cast<char>('0' + value / 10);
+                destination[1] = static_cast<char>('0' + value % 10);
+            };
+            write_two_digits(cached_text, local_time.tm_hour);
+            cached_text[2] = ':';
+            write_two_digits(cached_text + 3, local_time.tm_min);
+            cached_text[5] = ':';
+            write_two_digits(cached_text + 6, local_time.tm_sec);
+            cached_second = global_time;
+        }
+
+        buffer.append(cached_text, sizeof(cached_text));
+        buffer.push_back('.');
+        buffer.push_back(static_cast<char>('0' + millisecond / 100));
+        buffer.push_back(static_cast<char>('0' + millisecond / 10 % 10));
+        buffer.push_back(static_cast<char>('0' + millisecond % 10));
+    }
+
+    /// Get the name text of the given severity.
+    std::string_view LogFormatter::GetSeverityName(LogSeverity severity) noexcept
+    {
+        switch (severity)
+        {
+            case LogSeverity::Message:
+                return "Message";
+            case LogSeverity::Milestone:
+                return "Milestone";
+            case LogSeverity::Warning:
+                return "Warning";
+            case LogSeverity::Error:
+                return "Error";
+            default:
+                return "";
+        }
+    }
+
+    /// Parse a severity from its name or its number.
+    std::optional<LogSeverity> LogFormatter::ParseSeverity(std::string_view text) noexcept
+    {
+        for (auto severity : {LogSeverity::Message, LogSeverity::Milestone, LogSeverity::Warning, LogSeverity::Error})
+        {
+            auto name = GetSeverityName(severity);
+            if (text.size() == 1 && text[0] - '0' == static_cast<int>(severity)) return severity;
+            if (text.size() != name.size()) continue;
+            bool matched = true;
+            for (std::size_t index = 0; index < name.size() && matched; ++index)
+            {
+                matched = std::tolower(static_cast<unsigned char>(text[index])) ==
+                          std::tolower(static_cast<unsigned char>(name[index]));
+            }
+            if (matched) return severity;
+        }
+        return std::nullopt;
+    }
+
+    /// Append the "time|severity|author|" part of a log line.
+    void LogFormatter::AppendHeader(std::string& buffer, LogSeverity severity, std::string_view author)
+    {
+        AppendTimestamp(buffer, std::chrono::system_clock::now());
+        buffer.push_back('|');
+        buffer.append(GetSeverityName(severity));
+        buffer.push_back('|');
+        buffer.append(author);
+        buffer.push_back('|');
+    }
+
+    /// Append the literal text until the next placeholder.
+    std::size_t LogFormatter::AppendLiteral(std::string& buffer, std::string_view format)
+    {
+        std::size_t position = 0;
+        while (position < format.size())
+        {
+            auto brace_position = format.find_first_of("{}", position);
+            if (brace_position == std::string_view::npos)
+            {
+                buffer.append(format.substr(position));
+                return std::string_view::npos;
+            }
+            buffer.append(format.substr(position, brace_position - position));
+            auto brace = format[brace_position];
+            auto next_character = brace_position + 1 < format.size() ? format[brace_position + 1] : '\0';
+            if (brace == '{' && next_character == '}')
+            {
+                return brace_position;
+            }
+            buffer.push_back(brace);
+            // Skip the second brace of "{{" and "}}".
+            position = brace_position + (next_character == brace ? 2 : 1);
+        }
+        return std::string_view::npos;
+    }
+
+    /// Render a log line with the current time.
+    const std::string& LogFormatter::Format(LogSeverity severity, std::string_view author, std::string_view text)
+    {
+        auto& buffer = GetBuffer();
+        AppendHeader(buffer, severity, author);
+        buffer.append(text);
+        return buffer;
+    }
+}
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <chrono>
+#include <optional>
+#include <charconv>
+#include <sstream>
+#include <type_traits>
+#include "LogSeverity.hpp"
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Formatter which renders log lines in the format of "time|severity|author|text".
+     * @details
+     *  Log lines are rendered into a reused thread local buffer,
+     *  and the second part of the timestamp is cached for every thread,
+     *  so formatting a log line normally does not allocate memory or query the time zone.
+     */
+    class LogFormatter
+    {
+    private:
+        /// Get the reused log line buffer of the current thread.
+        static std::string& GetBuffer();
+        /// Get the reused log text buffer of the current thread.
+        static std::string& GetTextBuffer();
+
+        /// Append the "time|severity|author|" part of a log line.
+        static void AppendHeader(std::string& buffer, LogSeverity severity, std::string_view author);
+
+        /**
+         * @brief Append the given literal text, and replace "{{" and "}}" with "{" and "}".
+         * @return Position of the next "{}" placeholder, or std::string_view::npos if there is none.
+         */
+        static std::size_t AppendLiteral(std::string& buffer, std::string_view format);
+
+        /// Append the remaining format text when there is no argument to render.
+        static void AppendFormatPart(std::string& buffer, std::string_view format)
+        {
+            while (!format.empty())
+            {
+                auto placeholder_position = AppendLiteral(buffer, format);
+                if (placeholder_position == std::string_view::npos) return;
+                // No argument for this placeholder, keep it as it is.
+                buffer.append("{}");
+                format.remove_prefix(placeholder_position + 2);
+            }
+        }
+
+        /// Append the format text until the next placeholder, then render the argument into it.
+        template <typename ArgumentType, typename... ArgumentTypes>
+        static void AppendFormatPart(std::string& buffer, std::string_view format,
+                                     const ArgumentType& argument, const ArgumentTypes&... arguments)
+        {
+            auto placeholder_position = AppendLiteral(buffer, format);
+            if (placeholder_position == std::string_view::npos) return;
+            AppendArgument(buffer, argument);
+            AppendFormatPart(buffer, format.substr(placeholder_position + 2), arguments...);
+        }
+
+    public:
+        /**
+         * @brief Append the local time text of the given time point in the format of "HH:MM:SS.mmm".
+         * @details The "HH:MM:SS" part is cached for every thread and only regenerated once per second.
+         */
+        static void AppendTimestamp(std::string& buffer, std::chrono::system_clock::time_point time_point);
+
+        /// Get the name text of the given severity.
+        static std::string_view GetSeverityName(LogSeverity severity) noexcept;
+
+        /**
+         * @brief Parse a severity from its name or its number, such as "Warning", "warning" or "2".
+         * @return The parsed severity, or std::nullopt if the text is not a valid severity.
+         */
+        static std::optional<LogSeverity> ParseSeverity(std::string_view text) noexcept;
+
+        /**
+         * @brief Render an argument into the buffer.
+         * @details
+         *  Strings are appended directly, null C strings as "(null)", numbers are rendered with std::to_chars,
+         *  enumerations are rendered as their underlying values,
+         *  and other types are rendered with their operator<<.
+         */
+        template <typename ArgumentType>
+        static void AppendArgument(std::string& buffer, const ArgumentType& argument)
+        {
+            using ValueType = std::decay_t<ArgumentType>;
+            if constexpr (std::is_same_v<ValueType, bool>)
+            {
+                buffer.append(argument ? "true" : "false");
+            }
+            else if constexpr (std::is_same_v<ValueType, char>)
+            {
+                buffer.push_back(argument);
+            }
+            else if constexpr (std::is_pointer_v<ArgumentType> &&
+                               std::is_convertible_v<const ArgumentType&, std::string_view>)
+            {
+                // Viewing a null C string is undefined.
+                buffer.append(argument ? std::string_view(argument) : std::string_view("(null)"));
+            }
+            else if constexpr (std::is_convertible_v<const ArgumentType&, std::string_view>)
+            {
+                buffer.append(std::string_view(argument));
+            }
+            else if constexpr (std::is_arithmetic_v<ValueType>)
+            {
+                char text[64];
+                auto result = std::to_chars(text, text + sizeof(text), argument);
+                buffer.append(text, result.ptr);
+            }
+            else if constexpr (std::is_enum_v<ValueType>)
+            {
+                AppendArgument(buffer, static_cast<std::underlying_type_t<ValueType>>(argument));
+            }
+            else
+            {
+                thread_local std::ostringstream stream;
+                stream.str(std::string());
+                stream.clear();
+                stream << argument;
+                buffer.append(stream.str());
+            }
+        }
+
+        /**
+         * @brief Render the format text into the buffer, every "{}" will be replaced with the next argument.
+         * @details "{{" and "}}" are rendered as "{" and "}".
+         */
+        template <typename... ArgumentTypes>
+        static void AppendFormat(std::string& buffer, std::string_view format, const ArgumentTypes&... arguments)
+        {
+            AppendFormatPart(buffer, format, arguments...);
+        }
+
+        /**
+         * @brief Render the text of a log without the time, severity and author.
+         * @return Reference to the rendered text, which stays valid until the next FormatText(...) in this thread.
+         */
+        template <typename... ArgumentTypes>
+        static const std::string& FormatText(std::string_view format, const ArgumentTypes&... arguments)
+        {
+            auto& buffer = GetTextBuffer();
+            AppendFormat(buffer, format, arguments...);
+            return buffer;
+        }
+
+        /**
+         * @brief Render a log line with the current time.
+         * @return Reference to the rendered line, which stays valid until the next formatting in this thread.
+         */
+        static const std::string& Format(LogSeverity severity, std::string_view author, std::string_view text);
+
+        /**
+         * @brief Render a log line whose text is formatted from the format text and arguments.
+         * @return Reference to the rendered line, which stays valid until the next formatting in this thread.
+         */
+        template <typename... ArgumentTypes>
+        static const std::string& Format(LogSeverity severity, std::string_view author,
+                                         std::string_view format, const ArgumentTypes&... arguments)
+        {
+            auto& buffer = GetBuffer();
+            AppendHeader(buffer, severity, author);
+            AppendFormat(buffer, format, arguments...);
+            return buffer;
+        }
+    };
+}
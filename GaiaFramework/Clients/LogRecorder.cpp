@@ -3,28 +3,24 @@
 #include <ctime>
 #include <chrono>
 #include <sstream>
+#include <algorithm>
+#include <thread>
+#include <filesystem>
 
 #include <iostream>
 
 namespace Gaia::Framework::Clients
 {
     /// Construct and create the log file.
-    LogRecorder::LogRecorder(const std::string& unit_name) noexcept
+    LogRecorder::LogRecorder(const std::string& unit_name) noexcept :
+        Writer([this](const std::atomic_bool& life_flag){
+            this->WritePendingTexts(life_flag);
+        }), UnitName(unit_name)
     {
         try
         {
-            auto current_time_point = std::chrono::system_clock::now();
-            LastAutoSaveTime = current_time_point;
-            auto global_time = std::chrono::system_clock::to_time_t(current_time_point);
-            auto local_time = std::localtime(&global_time);
-
-            std::stringstream file_name_builder;
-            if (!unit_name.empty()) file_name_builder << unit_name << " ";
-            file_name_builder << local_time->tm_mon + 1 << "-" << local_time->tm_mday << " ";
-            file_name_builder << local_time->tm_hour << ":" << local_time->tm_min << ":" << local_time->tm_sec;
-            file_name_builder << ".log";
-
-            LogFilePath = file_name_builder.str();
+            LastAutoSaveTime = std::chrono::system_clock::now();
+            LogFilePath = GenerateLogFilePath();
         }
         catch (std::exception& error)
         {
@@ -32,89 +28,284 @@ namespace Gaia::Framework::Clients
         }
     }
 
+    /// Generate a log file path which does not exist yet.
+    std::string LogRecorder::GenerateLogFilePath()
+    {
+        auto current_time_point = std::chrono::system_clock::now();
+        auto global_time = std::chrono::system_clock::to_time_t(current_time_point);
+        std::tm local_time {};
+        localtime_r(&global_time, &local_time);
+
+        std::stringstream file_name_builder;
+        if (!UnitName.empty()) file_name_builder << UnitName << " ";
+        file_name_builder << local_time.tm_mon + 1 << "-" << local_time.tm_mday << " ";
+        file_name_builder << local_time.tm_hour << ":" << local_time.tm_min << ":" << local_time.tm_sec;
+        auto file_name = file_name_builder.str();
+
+        // Rotated files are distinguished by increasing sequence numbers.
+        auto file_path = LogFileSequence == 0 ? file_name + ".log" :
+                file_name + "." + std::to_string(LogFileSequence) + ".log";
+        std::error_code error;
+        while (std::filesystem::exists(file_path, error) || std::filesystem::exists(file_path + ".gz", error))
+        {
+            file_path = file_name + "." + std::to_string(++LogFileSequence) + ".log";
+        }
+        ++LogFileSequence;
+        return file_path;
+    }
+
     /// Save the log and destruct.
     LogRecorder::~LogRecorder()
     {
+        DisableWriterThread();
         if (LogFile.is_open())
         {
             LogFile.close();
         }
+        // Wait for the archiver to compress the closed files.
+        Archiver.reset();
     }
 
     /// Redirect to the non-author Record function with a connected text of author and log content.
-    void LogRecorder::Record(const std::string &text, LogRecorder::Severity level, const std::string& author)
+    void LogRecorder::Record(std::string_view text, LogRecorder::Severity level, std::string_view author)
     {
-        RecordRawText(GenerateLogText(text, level, author));
+        if (!IsEnabled(level)) return;
+        if (auto segment_writer = std::atomic_load(&SegmentWriter))
+        {
+            AppendSegmentRecord(*segment_writer, level, author, text);
+            return;
+        }
+        RecordRawText(LogFormatter::Format(level, author, text));
     }
 
     /// Save the current recorded log into the log file.
     void LogRecorder::Flush()
     {
+        std::unique_lock lock(OperationMutex);
         if (LogFile.is_open())
         {
             LogFile.flush();
         }
     }
 
+    /// Open the log file if it has not been opened yet.
+    void LogRecorder::OpenLogFile()
+    {
+        if (!LogFile.is_open() && !LogFilePath.empty())
+        {
+            LogFile.open(LogFilePath, std::ios::out);
+            LogFileSize = 0;
+            LogFileOpenTime = std::chrono::system_clock::now();
+        }
+    }
+
+    /// Count the written size and start a new log file if the current one should be rotated.
+    void LogRecorder::UpdateRotation(std::size_t written_size,
+                                     std::chrono::system_clock::time_point current_time_point)
+    {
+        LogFileSize += written_size;
+        if (!Archiver || !LogFile.is_open()) return;
+        if ((Rotation.MaxFileSize == 0 || LogFileSize < Rotation.MaxFileSize) &&
+            (Rotation.Period.count() == 0 || current_time_point - LogFileOpenTime < Rotation.Period))
+        {
+            return;
+        }
+
+        LogFile.close();
+        Archiver->Archive(LogFilePath);
+        // The new log file will be opened by the next record.
+        LogFilePath = GenerateLogFilePath();
+    }
+
+    /// Rotate log files by size and time, and archive closed log files on a background thread.
+    void LogRecorder::EnableRotation(const RotationOptions& options)
+    {
+        std::unique_lock lock(OperationMutex);
+        Rotation = options;
+        auto directory = std::filesystem::path(LogFilePath).parent_path().string();
+        Archiver = std::make_unique<LogArchiver>(directory, UnitName.empty() ? "" : UnitName + " ", LogFilePath,
+                                                 Rotation.Compress, Rotation.RetentionBytes);
+    }
+
     /// Generate a log text in the log format.
     std::string LogRecorder::GenerateLogText(const std::string& text, LogRecorder::Severity severity,
                                              const std::string& author)
     {
-        auto current_time_point = std::chrono::system_clock::now();
-        auto global_time = std::chrono::system_clock::to_time_t(current_time_point);
-        auto local_time = std::localtime(&global_time);
-
-        std::stringstream builder;
-        builder << local_time->tm_hour << ":" << local_time->tm_min << ":" << local_time->tm_sec;
-        builder << "|";
-        switch (severity)
-        {
-            case Severity::Message:
-                builder << "Message";
-                break;
-            case Severity::Milestone:
-                builder << "Milestone";
-                break;
-            case Severity::Warning:
-                builder << "Warning";
-                break;
-            case Severity::Error:
-                builder << "Error";
-                break;
-            default:
-                break;
-        }
-        builder << "|" << author << "|" << text;
-
-        return builder.str();
+        return LogFormatter::Format(severity, author, text);
     }
 
     /// Record a raw text into the log.
     void LogRecorder::RecordRawText(const std::string& text)
     {
-        if (!LogFile.is_open() && !LogFilePath.empty())
+        if (auto segment_writer = std::atomic_load(&SegmentWriter))
         {
-            LogFile.open(LogFilePath, std::ios::out);
+            AppendSegmentRecord(*segment_writer, Severity::Message, "", text);
+            return;
         }
 
+        // Registered before the mode is checked, so disabling the mode waits for this push to finish.
+        ++PushingCount;
+        if (WriterMode)
+        {
+            PendingTexts.Push(text);
+            --PushingCount;
+            // Only one producer needs to wake up the idle writer.
+            if (WriterIdle.load(std::memory_order_relaxed) && WriterIdle.exchange(false))
+            {
+                WriterIdleCondition.notify_one();
+            }
+            return;
+        }
+        --PushingCount;
+
         std::unique_lock operation_lock(OperationMutex);
 
+        OpenLogFile();
         if (LogFile.is_open())
         {
-            LogFile << text << std::endl;
+            LogFile << text << '\n';
             auto current_time_point = std::chrono::system_clock::now();
             if (current_time_point - LastAutoSaveTime > AutoSaveDuration)
             {
                 LogFile.flush();
                 LastAutoSaveTime = current_time_point;
             }
+            UpdateRotation(text.size() + 1, current_time_point);
         }
 
+        operation_lock.unlock();
+
         if (PrintToConsole)
         {
-            std::cout << text << std::endl;
+            std::cout << text << '\n';
         }
+    }
 
+    /// Write pending texts in buffered blocks until the life flag is false.
+    void LogRecorder::WritePendingTexts(const std::atomic_bool& life_flag)
+    {
+        std::string buffer;
+        buffer.reserve(WriteBufferSize);
+
+        auto write_buffer = [this, &buffer](bool flush){
+            std::unique_lock operation_lock(OperationMutex);
+            OpenLogFile();
+            if (LogFile.is_open() && !buffer.empty())
+            {
+                LogFile.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            }
+            auto current_time_point = std::chrono::system_clock::now();
+            if (LogFile.is_open() && (flush || current_time_point - LastAutoSaveTime > AutoSaveDuration))
+            {
+                LogFile.flush();
+                LastAutoSaveTime = current_time_point;
+            }
+            if (LogFile.is_open())
+            {
+                UpdateRotation(buffer.size(), current_time_point);
+            }
+            operation_lock.unlock();
+            if (PrintToConsole && !buffer.empty())
+            {
+                std::cout.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+                std::cout.flush();
+            }
+            buffer.clear();
+        };
+
+        auto last_write_time = std::chrono::system_clock::now();
+        while (true)
+        {
+            bool stopping = !life_flag.load();
+            while (auto text = PendingTexts.Pop())
+            {
+                buffer.append(*text);
+                buffer.push_back('\n');
+                if (buffer.size() >= WriteBufferSize)
+                {
+                    write_buffer(false);
+                    last_write_time = std::chrono::system_clock::now();
+                }
+            }
+            if (stopping) break;
+
+            // Buffered texts are written when the buffer is full or the auto-save interval is up.
+            auto current_time_point = std::chrono::system_clock::now();
+            if (!buffer.empty() && current_time_point - last_write_time > AutoSaveDuration)
+            {
+                write_buffer(true);
+                last_write_time = current_time_point;
+            }
+
+            // Yield for a while before sleeping, so that a steady stream of texts never wakes up the writer.
+            for (unsigned int yield_count = 0; yield_count < 64 && PendingTexts.IsEmpty(); ++yield_count)
+            {
+                std::this_thread::yield();
+            }
+            if (!PendingTexts.IsEmpty()) continue;
+
+            std::unique_lock idle_lock(WriterIdleMutex);
+            WriterIdle = true;
+            if (PendingTexts.IsEmpty())
+            {
+                WriterIdleCondition.wait_for(idle_lock, std::chrono::milliseconds(10));
+            }
+            WriterIdle = false;
+        }
+        write_buffer(true);
+    }
+
+    /// Write logs on a dedicated writer thread.
+    void LogRecorder::EnableWriterThread(std::size_t buffer_size, std::chrono::milliseconds flush_interval)
+    {
+        DisableWriterThread();
+        WriteBufferSize = std::max<std::size_t>(buffer_size, 1);
+        std::unique_lock operation_lock(OperationMutex);
+        AutoSaveDuration = flush_interval;
         operation_lock.unlock();
+        WriterMode = true;
+        Writer.Start();
+    }
+
+    /// Stop the writer thread after writing all pending logs.
+    void LogRecorder::DisableWriterThread()
+    {
+        if (!WriterMode.exchange(false)) return;
+        // Threads which saw the writer mode have pushed their texts once the count drops to 0.
+        while (PushingCount.load() > 0)
+        {
+            std::this_thread::yield();
+        }
+        WriterIdleCondition.notify_one();
+        Writer.Stop();
+        // Write texts pushed while the writer thread was stopping.
+        while (auto text = PendingTexts.Pop())
+        {
+            RecordRawText(*text);
+        }
+    }
+
+    /// Write logs into memory-mapped binary segment files.
+    void LogRecorder::EnableBinarySegments(const std::string& directory, std::uint64_t segment_size)
+    {
+        DisableWriterThread();
+        std::unique_lock operation_lock(OperationMutex);
+        // Recording threads keep the previous writer alive until their appends finish.
+        std::atomic_store(&SegmentWriter, std::make_shared<LogSegmentWriter>(
+                directory, UnitName.empty() ? "Log" : UnitName, segment_size));
+    }
+
+    /// Append a record into the binary log segments.
+    void LogRecorder::AppendSegmentRecord(LogSegmentWriter& writer, Severity level, std::string_view author,
+                                          std::string_view text)
+    {
+        auto current_time_point = std::chrono::system_clock::now();
+        writer.Append(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                current_time_point.time_since_epoch()).count(), level, author, text);
+
+        if (PrintToConsole)
+        {
+            std::cout << LogFormatter::Format(level, author, text) << '\n';
+        }
     }
 }
@@ -1,10 +1,19 @@
 #pragma once
 
 #include <string>
+#include <string_view>
+#include <memory>
 #include <fstream>
 #include <chrono>
 #include <mutex>
 #include <atomic>
+#include <condition_variable>
+#include <GaiaBackground/GaiaBackground.hpp>
+#include "../Containers/MpscQueue.hpp"
+#include "LogSeverity.hpp"
+#include "LogFormatter.hpp"
+#include "LogSegmentWriter.hpp"
+#include "LogArchiver.hpp"
 
 namespace Gaia::Framework::Clients
 {
@@ -12,17 +21,26 @@ namespace Gaia::Framework::Clients
      * @brief A log recorder will record logs into a text file.
      * @details
      *  Its Record(...) function is multi-threads safe to use.
+     *  In writer thread mode, recording threads only push the text into a lock-free queue,
+     *  and a dedicated writer thread writes them into the file in large buffered blocks.
      */
     class LogRecorder
     {
     public:
         /// Severity to mark how important a piece of log is.
-        enum class Severity
+        using Severity = LogSeverity;
+
+        /// Options of log file rotation.
+        struct RotationOptions
         {
-            Message = 0,    ///< Message stands for basic output information.
-            Milestone = 1,  ///< Milestone stands for the important time point of the application life circle.
-            Warning = 2,    ///< Warning stands for abnormal situations which are not deadly.
-            Error = 3       ///< Error stands for critical deadly abnormal situations.
+            /// Start a new log file when the current one reaches this size in bytes, 0 means unlimited.
+            std::uint64_t MaxFileSize {0};
+            /// Start a new log file when the current one has been used for this period, 0 means unlimited.
+            std::chrono::seconds Period {0};
+            /// Maximum total size of closed log files in bytes, the oldest ones are removed, 0 means unlimited.
+            std::uint64_t RetentionBytes {0};
+            /// Whether closed log files will be compressed into ".gz" files or not.
+            bool Compress {true};
         };
 
     protected:
@@ -39,6 +57,55 @@ namespace Gaia::Framework::Clients
         /// Mutex for log file and timestamp of auto-save.
         std::mutex OperationMutex;
 
+        /// Open the log file if it has not been opened yet. OperationMutex should be held.
+        void OpenLogFile();
+
+        /// Sequence number of the latest rotated log file.
+        unsigned int LogFileSequence {0};
+        /// Generate a log file path which does not exist yet, rotated files are marked with sequence numbers.
+        std::string GenerateLogFilePath();
+
+        /// Options of log file rotation.
+        RotationOptions Rotation;
+        /// Size of the data written into the current log file.
+        std::uint64_t LogFileSize {0};
+        /// Time point when the current log file is opened.
+        std::chrono::system_clock::time_point LogFileOpenTime;
+        /// Archiver of closed log files, null if rotation is not enabled.
+        std::unique_ptr<LogArchiver> Archiver;
+        /**
+         * @brief Count the written size and start a new log file if the current one should be rotated.
+         * @details OperationMutex should be held.
+         */
+        void UpdateRotation(std::size_t written_size, std::chrono::system_clock::time_point current_time_point);
+
+        /// Size of the write buffer, it will be written into the file when it is full.
+        std::size_t WriteBufferSize {64 * 1024};
+        /// Whether texts are written by the writer thread or not.
+        std::atomic_bool WriterMode {false};
+        /// Count of threads between checking the writer mode and pushing their texts.
+        std::atomic<unsigned int> PushingCount {0};
+        /// Texts waiting to be written by the writer thread.
+        Containers::MpscQueue<std::string> PendingTexts;
+        /// Whether the writer thread is waiting for new texts or not.
+        std::atomic_bool WriterIdle {false};
+        /// Mutex for the writer idle condition.
+        std::mutex WriterIdleMutex;
+        /// Notified when new texts are pushed while the writer thread is idle.
+        std::condition_variable WriterIdleCondition;
+        /// Write pending texts in buffered blocks until the life flag is false.
+        void WritePendingTexts(const std::atomic_bool& life_flag);
+        /// Background worker which writes the pending texts.
+        Gaia::Background::BackgroundWorker Writer;
+
+        /// Name of the unit which owns the log files.
+        std::string UnitName;
+        /// Writer of binary log segments, logs are written as text if it is null. Only accessed by atomic operations.
+        std::shared_ptr<LogSegmentWriter> SegmentWriter;
+        /// Append a record into the binary log segments.
+        void AppendSegmentRecord(LogSegmentWriter& writer, Severity level, std::string_view author,
+                                 std::string_view text);
+
     public:
         /// Generate a log text in the log format.
         static std::string GenerateLogText(const std::string& text, Severity severity, const std::string& author = "Anonymous");
@@ -55,6 +122,16 @@ namespace Gaia::Framework::Clients
         /// Whether the log will be printed to the console or not.
         bool PrintToConsole {false};
 
+        /// Logs below this severity will be discarded by Record(...) and RecordFormat(...).
+        std::atomic<Severity> MinimumSeverity {Severity::Message};
+
+        /// Check whether logs of the given severity will be recorded or not.
+        [[nodiscard]] inline bool IsEnabled(Severity severity) const noexcept
+        {
+            return IsSeverityCompiled(severity) &&
+                static_cast<int>(severity) >= static_cast<int>(MinimumSeverity.load(std::memory_order_relaxed));
+        }
+
         /// Record a raw text into the log.
         void RecordRawText(const std::string& text);
 
@@ -64,11 +141,68 @@ namespace Gaia::Framework::Clients
          * @param text The log text.
          * @param level The level of the log.
          */
-        void Record(const std::string& text, Severity level = Severity::Message, const std::string& author = "Anonymous");
+        void Record(std::string_view text, Severity level = Severity::Message, std::string_view author = "Anonymous");
 
         /// Save the current recorded log into the log file.
         void Flush();
 
+        /**
+         * @brief Write logs on a dedicated writer thread.
+         * @param buffer_size Size of the write buffer, logs are written into the file when it is full.
+         * @param flush_interval Maximum time a written log can stay in the buffer before it is flushed.
+         * @details
+         *  Recording a log in this mode only costs a lock-free queue push.
+         */
+        void EnableWriterThread(std::size_t buffer_size = 64 * 1024,
+                                std::chrono::milliseconds flush_interval = std::chrono::milliseconds(1000));
+        /// Stop the writer thread after writing all pending logs, then write logs on the recording thread.
+        void DisableWriterThread();
+
+        /**
+         * @brief Rotate log files by size and time, and archive closed log files on a background thread.
+         * @param options Options of the rotation.
+         * @details Closed log files are compressed and removed by the retention limit off the recording path.
+         */
+        void EnableRotation(const RotationOptions& options);
+
+        /**
+         * @brief Write logs into memory-mapped binary segment files instead of the text log file.
+         * @param directory Directory to place segment files.
+         * @param segment_size Size of every preallocated segment file.
+         * @details
+         *  Every record is stored with its timestamp, severity and author in a fixed header,
+         *  segments can be queried by LogSegmentReader.
+         *  It can be called while other threads are recording, their logs are written into the new segments
+         *  once it returns.
+         */
+        void EnableBinarySegments(const std::string& directory, std::uint64_t segment_size = 64 * 1024 * 1024);
+        /// Check whether logs are written into binary segments or not.
+        [[nodiscard]] inline bool IsBinaryMode() const noexcept
+        {
+            return std::atomic_load(&SegmentWriter) != nullptr;
+        }
+
+        /**
+         * @brief Record a log whose text is formatted from the given format and arguments.
+         * @param level The level of the log.
+         * @param author The name of the object which produce this log.
+         * @param format Format text, every "{}" will be replaced with the next argument.
+         * @param arguments Arguments to render into the text.
+         * @details The log line is rendered in a reused thread local buffer.
+         */
+        template <typename... ArgumentTypes>
+        void RecordFormat(Severity level, std::string_view author, std::string_view format,
+                          const ArgumentTypes&... arguments)
+        {
+            if (!IsEnabled(level)) return;
+            if (auto segment_writer = std::atomic_load(&SegmentWriter))
+            {
+                AppendSegmentRecord(*segment_writer, level, author, LogFormatter::FormatText(format, arguments...));
+                return;
+            }
+            RecordRawText(LogFormatter::Format(level, author, format, arguments...));
+        }
+
         /// Record a message. Equals Record(..., Severity::Message).
         template<typename AuthorType, typename TextType>
         inline void RecordMessage(TextType&& text, AuthorType&& author)
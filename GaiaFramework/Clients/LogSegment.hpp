@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Gaia::Framework::Clients::LogSegment
+{
+    /**
+     * @brief Layout of a binary log segment file.
+     * @details
+     *  A segment file is made of a Header, an index table of IndexCapacity IndexEntry,
+     *  an author table of AuthorCapacity AuthorEntry, and then the records.
+     *  Every record is a RecordHeader followed by its text, padded to 8 bytes.
+     *  Records are appended in the order of their timestamps,
+     *  and an index entry is added every time the records grow by IndexStride bytes,
+     *  so readers can binary search the index by timestamp and only scan a small range of records.
+     */
+
+    /// Magic number at the beginning of every segment file, "GAIALOGS" in little-endian.
+    constexpr std::uint64_t Magic = 0x53474F4C41494147ULL;
+    /// Version of the segment layout.
+    constexpr std::uint32_t Version = 1;
+    /// Extension name of segment files.
+    constexpr std::string_view Extension = ".gseg";
+
+    /// Header at the beginning of a segment file.
+    struct Header
+    {
+        /// Always equals to Magic.
+        std::uint64_t Magic;
+        /// Version of the segment layout.
+        std::uint32_t Version;
+        /// Capacity of the index table.
+        std::uint32_t IndexCapacity;
+        /// Count of valid entries in the index table.
+        std::uint32_t IndexCount;
+        /// Capacity of the author table.
+        std::uint32_t AuthorCapacity;
+        /// Count of valid entries in the author table.
+        std::uint32_t AuthorCount;
+        /// Reserved for alignment.
+        std::uint32_t Reserved;
+        /// Offset of the first record.
+        std::uint64_t RecordsBegin;
+        /// Offset of the end of the last completely written record.
+        std::uint64_t RecordsEnd;
+        /// Count of records in this segment.
+        std::uint64_t RecordCount;
+        /// Records grow by this amount of bytes between two index entries.
+        std::uint64_t IndexStride;
+        /// Timestamp of the first record, in nanoseconds since the epoch.
+        std::int64_t FirstTimestamp;
+        /// Timestamp of the last record, in nanoseconds since the epoch.
+        std::int64_t LastTimestamp;
+    };
+
+    /// Entry of the sparse timestamp index.
+    struct IndexEntry
+    {
+        /// Timestamp of the indexed record, in nanoseconds since the epoch.
+        std::int64_t Timestamp;
+        /// Offset of the indexed record.
+        std::uint64_t Offset;
+    };
+
+    /// Entry of the author table, which maps author IDs to author names.
+    struct AuthorEntry
+    {
+        /// ID of the author.
+        std::uint32_t Id;
+        /// Length of the name, names longer than the name buffer are truncated.
+        std::uint32_t Length;
+        /// Name of the author.
+        char Name[56];
+    };
+
+    /// Fixed header of a record.
+    struct RecordHeader
+    {
+        /// Time of the record, in nanoseconds since the epoch.
+        std::int64_t Timestamp;
+        /// ID of the author, see GetAuthorId(...).
+        std::uint32_t AuthorId;
+        /// Severity of the record.
+        std::uint16_t Severity;
+        /// Reserved for flags.
+        std::uint16_t Reserved;
+        /// Length of the text following this header.
+        std::uint32_t Length;
+        /// Reserved for alignment.
+        std::uint32_t Padding;
+    };
+
+    static_assert(sizeof(Header) == 80, "Unexpected segment header size.");
+    static_assert(sizeof(IndexEntry) == 16, "Unexpected index entry size.");
+    static_assert(sizeof(AuthorEntry) == 64, "Unexpected author entry size.");
+    static_assert(sizeof(RecordHeader) == 24, "Unexpected record header size.");
+
+    /// Get the size of a record with the given text length, including the header and the padding.
+    constexpr std::uint64_t GetRecordSize(std::uint64_t text_length) noexcept
+    {
+        return (sizeof(RecordHeader) + text_length + 7) & ~static_cast<std::uint64_t>(7);
+    }
+
+    /// Get the ID of the given author name, which is its 32-bit FNV-1a hash.
+    constexpr std::uint32_t GetAuthorId(std::string_view author) noexcept
+    {
+        std::uint32_t hash = 2166136261u;
+        for (auto character : author)
+        {
+            hash ^= static_cast<unsigned char>(character);
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+}
@@ -0,0 +1,139 @@
+#include "LogSegmentReader.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace Gaia::Framework::Clients
+{
+    /// Find segment files in the given directory.
+    LogSegmentReader::LogSegmentReader(const std::string& directory, const std::string& prefix)
+    {
+        std::error_code error;
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error))
+        {
+            if (!entry.is_regular_file(error)) continue;
+            auto file_name = entry.path().filename().string();
+            if (entry.path().extension() != LogSegment::Extension) continue;
+            if (!prefix.empty() && file_name.compare(0, prefix.size() + 1, prefix + "-") != 0) continue;
+            SegmentPaths.push_back(entry.path().string());
+        }
+        // File names end with zero-padded timestamps of the first records.
+        std::sort(SegmentPaths.begin(), SegmentPaths.end(), [](const std::string& left, const std::string& right){
+            auto left_name = std::filesystem::path(left).stem().string();
+            auto right_name = std::filesystem::path(right).stem().string();
+            return left_name.substr(left_name.find_last_of('-') + 1) <
+                   right_name.substr(right_name.find_last_of('-') + 1);
+        });
+    }
+
+    /// Read records which match the query in the order of their timestamps.
+    std::size_t LogSegmentReader::Query(const LogQuery& query,
+                                        const std::function<bool(const LogEntry&)>& visitor) const
+    {
+        std::size_t count = 0;
+        auto counting_visitor = [&count, &visitor](const LogEntry& entry){
+            ++count;
+            return visitor(entry);
+        };
+        std::uint32_t author_id = query.Author.has_value() ? LogSegment::GetAuthorId(*query.Author) : 0;
+        for (const auto& path : SegmentPaths)
+        {
+            if (!QuerySegment(path, query, author_id, counting_visitor)) break;
+        }
+        return count;
+    }
+
+    /// Query records from one segment file.
+    bool LogSegmentReader::QuerySegment(const std::string& path, const LogQuery& query, std::uint32_t author_id,
+                                        const std::function<bool(const LogEntry&)>& visitor)
+    {
+        auto file = ::open(path.c_str(), O_RDONLY);
+        if (file < 0) return true;
+        struct stat file_status {};
+        if (::fstat(file, &file_status) != 0 ||
+            static_cast<std::uint64_t>(file_status.st_size) < sizeof(LogSegment::Header))
+        {
+            ::close(file);
+            return true;
+        }
+        auto file_size = static_cast<std::uint64_t>(file_status.st_size);
+        auto* mapping = ::mmap(nullptr, file_size, PROT_READ, MAP_SHARED, file, 0);
+        ::close(file);
+        if (mapping == MAP_FAILED) return true;
+        const auto* data = static_cast<const std::uint8_t*>(mapping);
+
+        bool keep_reading = true;
+        const auto* header = reinterpret_cast<const LogSegment::Header*>(data);
+        auto records_end = std::min(__atomic_load_n(&header->RecordsEnd, __ATOMIC_ACQUIRE), file_size);
+        auto tables_end = sizeof(LogSegment::Header) +
+                sizeof(LogSegment::IndexEntry) * header->IndexCapacity +
+                sizeof(LogSegment::AuthorEntry) * header->AuthorCapacity;
+
+        if (header->Magic == LogSegment::Magic && header->Version == LogSegment::Version &&
+            tables_end <= header->RecordsBegin && header->RecordsBegin <= records_end &&
+            header->RecordCount > 0 &&
+            header->FirstTimestamp <= query.EndTimestamp && header->LastTimestamp >= query.BeginTimestamp)
+        {
+            const auto* index_begin = reinterpret_cast<const LogSegment::IndexEntry*>(
+                    data + sizeof(LogSegment::Header));
+            const auto* index_end = index_begin + std::min(header->IndexCount, header->IndexCapacity);
+            const auto* authors_begin = reinterpret_cast<const LogSegment::AuthorEntry*>(
+                    data + sizeof(LogSegment::Header) + sizeof(LogSegment::IndexEntry) * header->IndexCapacity);
+            const auto* authors_end = authors_begin + std::min(header->AuthorCount, header->AuthorCapacity);
+
+            // Start from the last indexed record before the begin time.
+            auto offset = header->RecordsBegin;
+            auto index_finder = std::lower_bound(index_begin, index_end, query.BeginTimestamp,
+                                                 [](const LogSegment::IndexEntry& entry, std::int64_t timestamp){
+                return entry.Timestamp < timestamp;
+            });
+            if (index_finder != index_begin)
+            {
+                offset = std::max(offset, (index_finder - 1)->Offset);
+            }
+
+            while (offset + sizeof(LogSegment::RecordHeader) <= records_end)
+            {
+                const auto* record = reinterpret_cast<const LogSegment::RecordHeader*>(data + offset);
+                auto record_size = LogSegment::GetRecordSize(record->Length);
+                if (offset + record_size > records_end || record->Timestamp > query.EndTimestamp) break;
+                offset += record_size;
+
+                if (record->Timestamp < query.BeginTimestamp ||
+                    record->Severity < static_cast<std::uint16_t>(query.MinimumSeverity) ||
+                    (query.Author.has_value() && record->AuthorId != author_id))
+                {
+                    continue;
+                }
+
+                LogEntry entry {};
+                entry.Timestamp = record->Timestamp;
+                entry.Severity = static_cast<LogSeverity>(record->Severity);
+                entry.AuthorId = record->AuthorId;
+                auto author_finder = std::find_if(authors_begin, authors_end,
+                                                  [record](const LogSegment::AuthorEntry& author){
+                    return author.Id == record->AuthorId;
+                });
+                if (author_finder != authors_end)
+                {
+                    entry.Author = std::string_view(author_finder->Name,
+                                                    std::min<std::size_t>(author_finder->Length,
+                                                                          sizeof(author_finder->Name)));
+                }
+                entry.Text = std::string_view(reinterpret_cast<const char*>(record + 1), record->Length);
+                if (!visitor(entry))
+                {
+                    keep_reading = false;
+                    break;
+                }
+            }
+        }
+
+        ::munmap(mapping, file_size);
+        return keep_reading;
+    }
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <limits>
+#include <optional>
+#include <functional>
+#include <cstdint>
+#include "LogSegment.hpp"
+#include "LogSeverity.hpp"
+
+namespace Gaia::Framework::Clients
+{
+    /// A record read from a binary log segment.
+    struct LogEntry
+    {
+        /// Time of the record, in nanoseconds since the epoch.
+        std::int64_t Timestamp;
+        /// Severity of the record.
+        LogSeverity Severity;
+        /// ID of the author.
+        std::uint32_t AuthorId;
+        /// Name of the author, empty if it is not in the author table of the segment.
+        std::string_view Author;
+        /// Text of the record.
+        std::string_view Text;
+    };
+
+    /// Conditions of records to read from binary log segments.
+    struct LogQuery
+    {
+        /// Only records at or after this time will be read, in nanoseconds since the epoch.
+        std::int64_t BeginTimestamp {std::numeric_limits<std::int64_t>::min()};
+        /// Only records at or before this time will be read, in nanoseconds since the epoch.
+        std::int64_t EndTimestamp {std::numeric_limits<std::int64_t>::max()};
+        /// Only records at or above this severity will be read.
+        LogSeverity MinimumSeverity {LogSeverity::Message};
+        /// If not empty, only records of this author will be read.
+        std::optional<std::string> Author;
+    };
+
+    /**
+     * @brief Reader which queries records from binary log segments written by LogSegmentWriter.
+     * @details
+     *  Segments out of the queried time range are skipped by their headers,
+     *  and the first record to read in a segment is located by a binary search on its index,
+     *  so only records close to the queried range are scanned.
+     */
+    class LogSegmentReader
+    {
+    private:
+        /// Paths of segment files, sorted by the timestamps of their first records.
+        std::vector<std::string> SegmentPaths;
+
+        /**
+         * @brief Query records from one segment file.
+         * @return False if the visitor asked to stop.
+         */
+        static bool QuerySegment(const std::string& path, const LogQuery& query, std::uint32_t author_id,
+                                 const std::function<bool(const LogEntry&)>& visitor);
+
+    public:
+        /**
+         * @brief Find segment files in the given directory.
+         * @param directory Directory of segment files.
+         * @param prefix If not empty, only segment files with this prefix will be read.
+         */
+        explicit LogSegmentReader(const std::string& directory, const std::string& prefix = "");
+
+        /// Get paths of segment files, sorted by the timestamps of their first records.
+        [[nodiscard]] inline const std::vector<std::string>& GetSegmentPaths() const noexcept
+        {
+            return SegmentPaths;
+        }
+
+        /**
+         * @brief Read records which match the query in the order of their timestamps.
+         * @param query Conditions of the records to read.
+         * @param visitor Functor invoked for every matched record, return false to stop reading.
+         * @return Count of the visited records.
+         * @details Views in the entry are only valid during the visitor invocation.
+         */
+        std::size_t Query(const LogQuery& query, const std::function<bool(const LogEntry&)>& visitor) const;
+    };
+}
@@ -0,0 +1,203 @@
+#include "LogSegmentWriter.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace Gaia::Framework::Clients
+{
+    /// Offset of the first record in every segment.
+    static constexpr std::uint64_t RecordsBegin =
+            sizeof(LogSegment::Header) +
+            sizeof(LogSegment::IndexEntry) * LogSegmentWriter::IndexCapacity +
+            sizeof(LogSegment::AuthorEntry) * LogSegmentWriter::AuthorCapacity;
+
+    /// Prepare to write segments.
+    LogSegmentWriter::LogSegmentWriter(std::string directory, std::string prefix, std::uint64_t segment_size) :
+        Directory(std::move(directory)), Prefix(std::move(prefix)),
+        SegmentSize(std::max<std::uint64_t>(segment_size, RecordsBegin + 64 * 1024))
+    {}
+
+    /// Close the current segment.
+    LogSegmentWriter::~LogSegmentWriter()
+    {
+        std::unique_lock lock(WriteMutex);
+        CloseSegment();
+    }
+
+    /// Create and map a new segment file.
+    bool LogSegmentWriter::OpenSegment(std::int64_t timestamp)
+    {
+        std::error_code error;
+        if (!Directory.empty())
+        {
+            std::filesystem::create_directories(Directory, error);
+        }
+
+        // Zero-padded timestamps keep segment files sorted by their names.
+        auto timestamp_text = std::to_string(std::max<std::int64_t>(timestamp, 0));
+        timestamp_text.insert(0, 20 - std::min<std::size_t>(timestamp_text.size(), 20), '0');
+        auto path = (std::filesystem::path(Directory) /
+                (Prefix + "-" + timestamp_text + std::string(LogSegment::Extension))).string();
+
+        auto file = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (file < 0)
+        {
+            std::cout << "Failed to create log segment " << path << ": " << std::strerror(errno) << std::endl;
+            return false;
+        }
+        if (::ftruncate(file, static_cast<off_t>(SegmentSize)) != 0)
+        {
+            std::cout << "Failed to allocate log segment " << path << ": " << std::strerror(errno) << std::endl;
+            ::close(file);
+            return false;
+        }
+        auto* mapping = ::mmap(nullptr, SegmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+        if (mapping == MAP_FAILED)
+        {
+            std::cout << "Failed to map log segment " << path << ": " << std::strerror(errno) << std::endl;
+            ::close(file);
+            return false;
+        }
+
+        SegmentFile = file;
+        SegmentPath = std::move(path);
+        Mapping = static_cast<std::uint8_t*>(mapping);
+        SegmentAuthors.clear();
+        LastIndexedOffset = 0;
+
+        auto* header = GetHeader();
+        header->Magic = LogSegment::Magic;
+        header->Version = LogSegment::Version;
+        header->IndexCapacity = IndexCapacity;
+        header->IndexCount = 0;
+        header->AuthorCapacity = AuthorCapacity;
+        header->AuthorCount = 0;
+        header->Reserved = 0;
+        header->RecordsBegin = RecordsBegin;
+        header->RecordsEnd = RecordsBegin;
+        header->RecordCount = 0;
+        header->IndexStride = (SegmentSize - RecordsBegin + IndexCapacity - 1) / IndexCapacity;
+        header->FirstTimestamp = timestamp;
+        header->LastTimestamp = timestamp;
+        return true;
+    }
+
+    /// Unmap the current segment and truncate it to its used size.
+    void LogSegmentWriter::CloseSegment()
+    {
+        if (!Mapping) return;
+        auto used_size = GetHeader()->RecordsEnd;
+        ::msync(Mapping, SegmentSize, MS_SYNC);
+        ::munmap(Mapping, SegmentSize);
+        ::ftruncate(SegmentFile, static_cast<off_t>(used_size));
+        ::close(SegmentFile);
+        Mapping = nullptr;
+        SegmentFile = -1;
+        SegmentPath.clear();
+    }
+
+    /// Add the author to the author table of the current segment.
+    void LogSegmentWriter::AddAuthor(std::uint32_t author_id, std::string_view author)
+    {
+        auto* header = GetHeader();
+        if (header->AuthorCount >= AuthorCapacity || SegmentAuthors.count(author_id)) return;
+
+        auto* entry = reinterpret_cast<LogSegment::AuthorEntry*>(
+                Mapping + sizeof(LogSegment::Header) + sizeof(LogSegment::IndexEntry) * IndexCapacity) +
+                        header->AuthorCount;
+        entry->Id = author_id;
+        entry->Length = static_cast<std::uint32_t>(std::min(author.size(), sizeof(entry->Name)));
+        std::memcpy(entry->Name, author.data(), entry->Length);
+        ++header->AuthorCount;
+        SegmentAuthors.insert(author_id);
+    }
+
+    /// Append a record to the current segment.
+    bool LogSegmentWriter::Append(std::int64_t timestamp, LogSeverity severity,
+                                  std::string_view author, std::string_view text)
+    {
+        std::unique_lock lock(WriteMutex);
+
+        // Records can not be larger than a segment.
+        text = text.substr(0, std::min<std::uint64_t>(text.size(),
+                                                      SegmentSize - RecordsBegin - sizeof(LogSegment::RecordHeader)));
+        auto record_size = LogSegment::GetRecordSize(text.size());
+
+        if (Mapping && GetHeader()->RecordsEnd + record_size > SegmentSize)
+        {
+            CloseSegment();
+        }
+        if (!Mapping && !OpenSegment(timestamp))
+        {
+            return false;
+        }
+
+        auto* header = GetHeader();
+        // Keep timestamps in order even if the system clock goes backward.
+        timestamp = std::max(timestamp, header->LastTimestamp);
+        auto author_id = LogSegment::GetAuthorId(author);
+        AddAuthor(author_id, author);
+
+        auto offset = header->RecordsEnd;
+        auto* record = reinterpret_cast<LogSegment::RecordHeader*>(Mapping + offset);
+        record->Timestamp = timestamp;
+        record->AuthorId = author_id;
+        record->Severity = static_cast<std::uint16_t>(severity);
+        record->Reserved = 0;
+        record->Length = static_cast<std::uint32_t>(text.size());
+        record->Padding = 0;
+        std::memcpy(Mapping + offset + sizeof(LogSegment::RecordHeader), text.data(), text.size());
+
+        if (header->RecordCount == 0 || offset - LastIndexedOffset >= header->IndexStride)
+        {
+            if (header->IndexCount < IndexCapacity)
+            {
+                auto* entry = reinterpret_cast<LogSegment::IndexEntry*>(Mapping + sizeof(LogSegment::Header)) +
+                        header->IndexCount;
+                entry->Timestamp = timestamp;
+                entry->Offset = offset;
+                ++header->IndexCount;
+                LastIndexedOffset = offset;
+            }
+        }
+
+        if (header->RecordCount == 0)
+        {
+            header->FirstTimestamp = timestamp;
+        }
+        header->LastTimestamp = timestamp;
+        ++header->RecordCount;
+        // Update the end offset at last, so readers never see a partially written record.
+        __atomic_store_n(&header->RecordsEnd, offset + record_size, __ATOMIC_RELEASE);
+        return true;
+    }
+
+    /// Close the current segment.
+    void LogSegmentWriter::Rotate()
+    {
+        std::unique_lock lock(WriteMutex);
+        CloseSegment();
+    }
+
+    /// Schedule the dirty pages of the current segment to be written into the disk.
+    void LogSegmentWriter::Flush()
+    {
+        std::unique_lock lock(WriteMutex);
+        if (Mapping)
+        {
+            ::msync(Mapping, SegmentSize, MS_ASYNC);
+        }
+    }
+
+    /// Get the path of the current segment file.
+    std::string LogSegmentWriter::GetSegmentPath()
+    {
+        std::unique_lock lock(WriteMutex);
+        return SegmentPath;
+    }
+}
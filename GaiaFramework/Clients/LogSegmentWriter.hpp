@@ -0,0 +1,102 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <mutex>
+#include <unordered_set>
+#include "LogSegment.hpp"
+#include "LogSeverity.hpp"
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Writer which appends log records into preallocated memory-mapped binary segment files.
+     * @details
+     *  Segment files are named "<prefix>-<timestamp of the first record>.gseg" in the given directory,
+     *  and a new segment is started when the current one is full.
+     *  Its Append(...) function is multi-threads safe to use.
+     */
+    class LogSegmentWriter
+    {
+    public:
+        /// Capacity of the index table of every segment.
+        static constexpr std::uint32_t IndexCapacity = 4096;
+        /// Capacity of the author table of every segment.
+        static constexpr std::uint32_t AuthorCapacity = 256;
+
+    private:
+        /// Directory to place segment files.
+        const std::string Directory;
+        /// Prefix of segment file names.
+        const std::string Prefix;
+        /// Size of every segment file.
+        const std::uint64_t SegmentSize;
+
+        /// Mutex for the current segment.
+        std::mutex WriteMutex;
+        /// Path of the current segment file, empty if no segment is opened.
+        std::string SegmentPath;
+        /// File descriptor of the current segment file.
+        int SegmentFile {-1};
+        /// Memory mapping of the current segment file.
+        std::uint8_t* Mapping {nullptr};
+        /// Offset of the latest indexed record.
+        std::uint64_t LastIndexedOffset {0};
+        /// IDs of authors in the author table of the current segment.
+        std::unordered_set<std::uint32_t> SegmentAuthors;
+
+        /// Header of the current segment.
+        [[nodiscard]] inline LogSegment::Header* GetHeader() const noexcept
+        {
+            return reinterpret_cast<LogSegment::Header*>(Mapping);
+        }
+
+        /**
+         * @brief Create and map a new segment file. WriteMutex should be held.
+         * @param timestamp Timestamp of the first record, used in the file name.
+         * @retval true The segment is ready to write.
+         * @retval false Failed to create or map the segment file.
+         */
+        bool OpenSegment(std::int64_t timestamp);
+        /// Unmap the current segment and truncate it to its used size. WriteMutex should be held.
+        void CloseSegment();
+        /// Add the author to the author table of the current segment. WriteMutex should be held.
+        void AddAuthor(std::uint32_t author_id, std::string_view author);
+
+    public:
+        /**
+         * @brief Prepare to write segments, the first segment file is created by the first Append(...).
+         * @param directory Directory to place segment files, will be created if it does not exist.
+         * @param prefix Prefix of segment file names.
+         * @param segment_size Size of every preallocated segment file.
+         */
+        LogSegmentWriter(std::string directory, std::string prefix,
+                         std::uint64_t segment_size = 64 * 1024 * 1024);
+        /// Close the current segment.
+        ~LogSegmentWriter();
+
+        LogSegmentWriter(const LogSegmentWriter&) = delete;
+        LogSegmentWriter& operator=(const LogSegmentWriter&) = delete;
+
+        /**
+         * @brief Append a record to the current segment, a new segment will be started if it is full.
+         * @param timestamp Time of the record, in nanoseconds since the epoch.
+         * @param severity Severity of the record.
+         * @param author Author of the record.
+         * @param text Text of the record, will be truncated if it is larger than a segment.
+         * @retval true The record is appended.
+         * @retval false Failed to create a segment file.
+         */
+        bool Append(std::int64_t timestamp, LogSeverity severity, std::string_view author, std::string_view text);
+
+        /// Close the current segment, the next record will start a new segment.
+        void Rotate();
+
+        /// Schedule the dirty pages of the current segment to be written into the disk.
+        void Flush();
+
+        /// Get the path of the current segment file, empty if no segment is opened.
+        [[nodiscard]] std::string GetSegmentPath();
+    };
+}
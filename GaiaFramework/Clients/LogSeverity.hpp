@@ -0,0 +1,30 @@
+#pragma once
+
+/**
+ * @brief Compile-time minimum severity of logs, 0 for Message, 1 for Milestone, 2 for Warning and 3 for Error.
+ * @details Logs recorded through the GAIA_LOG_* macros below this severity are removed by the compiler.
+ */
+#ifndef GAIA_LOG_MINIMUM_SEVERITY
+#define GAIA_LOG_MINIMUM_SEVERITY 0
+#endif
+
+namespace Gaia::Framework::Clients
+{
+    /// Severity to mark how important a piece of log is.
+    enum class LogSeverity
+    {
+        Message = 0,    ///< Message stands for basic output information.
+        Milestone = 1,  ///< Milestone stands for the important time point of the application life circle.
+        Warning = 2,    ///< Warning stands for abnormal situations which are not deadly.
+        Error = 3       ///< Error stands for critical deadly abnormal situations.
+    };
+
+    /// Logs below this severity are removed at compile time.
+    constexpr LogSeverity CompiledMinimumSeverity = static_cast<LogSeverity>(GAIA_LOG_MINIMUM_SEVERITY);
+
+    /// Check whether logs of the given severity are compiled or not.
+    constexpr bool IsSeverityCompiled(LogSeverity severity) noexcept
+    {
+        return static_cast<int>(severity) >= static_cast<int>(CompiledMinimumSeverity);
+    }
+}
@@ -0,0 +1,145 @@
+#include "LogSpill.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+
+namespace Gaia::Framework::Clients
+{
+    /// Bind the spill file.
+    LogSpill::LogSpill(std::string path) :
+        SpillPath(std::move(path)), ReplayingPath(SpillPath + ".replaying")
+    {}
+
+    /// Append a text to the spill file and write it into the file system.
+    void LogSpill::Append(std::string_view text)
+    {
+        if (text.size() > MaxRecordSize) return;
+        auto length = static_cast<std::uint32_t>(text.size());
+        std::unique_lock lock(SpillMutex);
+        if (!SpillFile.is_open())
+        {
+            SpillFile.open(SpillPath, std::ios::out | std::ios::app | std::ios::binary);
+        }
+        SpillFile.write(reinterpret_cast<const char*>(&length), sizeof(length));
+        SpillFile.write(text.data(), static_cast<std::streamsize>(text.size()));
+        SpillFile.flush();
+        ++SpilledCount;
+    }
+
+    /// Check whether there are texts waiting to be replayed or not.
+    bool LogSpill::HasPending()
+    {
+        std::error_code error;
+        auto has_content = [&error](const std::string& path){
+            auto size = std::filesystem::file_size(path, error);
+            return !error && size > 0;
+        };
+        std::unique_lock lock(SpillMutex);
+        return has_content(ReplayingPath) || has_content(SpillPath);
+    }
+
+    /// Move the unread part of the replaying file into a new replaying file.
+    void LogSpill::KeepUnreplayed(std::ifstream& replaying_file)
+    {
+        auto temporary_path = ReplayingPath + ".tmp";
+        {
+            std::ofstream temporary_file(temporary_path, std::ios::out | std::ios::trunc | std::ios::binary);
+            temporary_file << replaying_file.rdbuf();
+        }
+        replaying_file.close();
+        std::error_code error;
+        std::filesystem::rename(temporary_path, ReplayingPath, error);
+    }
+
+    /// Replay a snapshot of the spilled texts in batches.
+    bool LogSpill::Replay(const Publisher& publisher, std::size_t batch_size, std::size_t rate,
+                          const std::atomic_bool& life_flag)
+    {
+        batch_size = std::max<std::size_t>(batch_size, 1);
+        std::error_code error;
+
+        if (!life_flag.load()) return false;
+
+        // Texts left by an interrupted replay are replayed before the current spill file.
+        // Only one snapshot is replayed, texts spilled meanwhile are left for the next replay.
+        if (!std::filesystem::exists(ReplayingPath, error))
+        {
+            std::unique_lock lock(SpillMutex);
+            if (SpillFile.is_open()) SpillFile.close();
+            auto spill_size = std::filesystem::file_size(SpillPath, error);
+            if (error || spill_size == 0) return true;
+            std::filesystem::rename(SpillPath, ReplayingPath, error);
+            if (error) return false;
+        }
+
+        auto replaying_size = std::filesystem::file_size(ReplayingPath, error);
+        if (error) return false;
+        std::ifstream replaying_file(ReplayingPath, std::ios::in | std::ios::binary);
+        std::vector<std::string> batch;
+        batch.reserve(batch_size);
+        auto batch_position = replaying_file.tellg();
+
+        auto publish_batch = [&]() -> bool {
+            auto begin_time = std::chrono::steady_clock::now();
+            try
+            {
+                publisher(batch);
+            }
+            catch (std::exception&)
+            {
+                return false;
+            }
+            if (rate > 0)
+            {
+                auto expected_duration = std::chrono::duration<double>(
+                        static_cast<double>(batch.size()) / static_cast<double>(rate));
+                auto end_time = begin_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                        expected_duration);
+                // Sleep in slices, so a stopping replay is not held by the rate limit.
+                while (life_flag.load() && std::chrono::steady_clock::now() < end_time)
+                {
+                    std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                            std::chrono::milliseconds(100), end_time - std::chrono::steady_clock::now()));
+                }
+            }
+            batch.clear();
+            batch_position = replaying_file.tellg();
+            return true;
+        };
+
+        bool interrupted = false;
+        while (!interrupted)
+        {
+            std::uint32_t length = 0;
+            if (!replaying_file.read(reinterpret_cast<char*>(&length), sizeof(length))) break;
+            // A corrupted length prefix ends the replay, instead of allocating whatever it claims.
+            auto remaining_size = replaying_size - static_cast<std::uintmax_t>(replaying_file.tellg());
+            if (length > MaxRecordSize || length > remaining_size) break;
+            std::string text(length, '\0');
+            // A record truncated by a crash is discarded.
+            if (!replaying_file.read(text.data(), length)) break;
+            batch.push_back(std::move(text));
+            if (batch.size() >= batch_size)
+            {
+                interrupted = !life_flag.load() || !publish_batch();
+            }
+        }
+        if (!interrupted && !batch.empty())
+        {
+            replaying_file.clear();
+            interrupted = !publish_batch();
+        }
+
+        if (interrupted)
+        {
+            replaying_file.clear();
+            replaying_file.seekg(batch_position);
+            KeepUnreplayed(replaying_file);
+            return false;
+        }
+        replaying_file.close();
+        std::filesystem::remove(ReplayingPath, error);
+        return true;
+    }
+}
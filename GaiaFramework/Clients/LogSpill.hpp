@@ -0,0 +1,83 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Durable on-disk buffer of log texts which could not be published.
+     * @details
+     *  Texts are appended to the spill file as length-prefixed records.
+     *  To replay, the spill file is renamed into "<spill file>.replaying" and read in batches,
+     *  while new texts are appended to a new spill file.
+     *  Texts are replayed at least once, a crash during the replay may replay a batch again.
+     *  A record whose length prefix exceeds the record size limit or the rest of the file is treated as corrupted,
+     *  and the rest of the replaying file is discarded.
+     */
+    class LogSpill
+    {
+    private:
+        /// Path of the spill file.
+        const std::string SpillPath;
+        /// Path of the spill file which is being replayed.
+        const std::string ReplayingPath;
+
+        /// Mutex for the spill file.
+        std::mutex SpillMutex;
+        /// Stream of the spill file, opened by the first appended text.
+        std::ofstream SpillFile;
+        /// Count of texts spilled by this instance.
+        std::atomic<std::uint64_t> SpilledCount {0};
+
+        /// Move the unread part of the replaying file into a new replaying file.
+        void KeepUnreplayed(std::ifstream& replaying_file);
+
+    public:
+        /// Maximum size of a spilled text, longer texts are not spilled.
+        static constexpr std::uint32_t MaxRecordSize = 16 * 1024 * 1024;
+
+        /// Functor to publish a batch of texts, it should throw an exception if the publishing failed.
+        using Publisher = std::function<void(const std::vector<std::string>&)>;
+
+        /**
+         * @brief Bind the spill file, texts left by previous runs will also be replayed.
+         * @param path Path of the spill file.
+         */
+        explicit LogSpill(std::string path);
+
+        /// Append a text to the spill file and write it into the file system, ignored if it exceeds MaxRecordSize.
+        void Append(std::string_view text);
+
+        /// Check whether there are texts waiting to be replayed or not.
+        [[nodiscard]] bool HasPending();
+
+        /**
+         * @brief Replay a snapshot of the spilled texts in batches.
+         * @param publisher Functor to publish a batch of texts.
+         * @param batch_size Maximum count of texts in a batch.
+         * @param rate Maximum count of texts to replay per second, 0 means unlimited.
+         * @param life_flag The replay stops when it turns false.
+         * @details
+         *  The replay covers the texts spilled before it starts, so it ends even if texts keep being spilled,
+         *  texts spilled during the replay are left for the next replay.
+         * @retval true The snapshot is replayed, or there was nothing to replay.
+         * @retval false The replay is interrupted, unreplayed texts are kept for the next replay.
+         */
+        bool Replay(const Publisher& publisher, std::size_t batch_size, std::size_t rate,
+                    const std::atomic_bool& life_flag);
+
+        /// Get the count of texts spilled by this instance.
+        [[nodiscard]] inline std::uint64_t GetSpilledCount() const noexcept
+        {
+            return SpilledCount.load();
+        }
+    };
+}
@@ -0,0 +1,158 @@
+#include "LogThrottle.hpp"
+
+#include <algorithm>
+#include <functional>
+
+namespace Gaia::Framework::Clients
+{
+    /// Groups idle for longer than this period without pending suppressed logs are evicted.
+    static constexpr auto GroupIdlePeriod = std::chrono::seconds(60);
+    /// Interval between two sweeps of the groups.
+    static constexpr auto SweepInterval = std::chrono::milliseconds(500);
+
+    /// Hash the severity and the template of a log.
+    static std::size_t HashGroup(LogSeverity severity, std::string_view template_text) noexcept
+    {
+        auto hash = std::hash<std::string_view>()(template_text);
+        return hash ^ (static_cast<std::size_t>(severity) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2));
+    }
+
+    /// Construct with the given options.
+    LogThrottle::LogThrottle(const Options& options) :
+        ThrottleOptions(options), SweepTime(Clock::now())
+    {}
+
+    /// Find or create the group of the given severity and template.
+    LogThrottle::Group& LogThrottle::AcquireGroup(LogSeverity severity, std::string_view template_text,
+                                                  Clock::time_point now)
+    {
+        auto hash = HashGroup(severity, template_text);
+        auto [begin, end] = Groups.equal_range(hash);
+        for (auto iterator = begin; iterator != end; ++iterator)
+        {
+            if (iterator->second.Severity == severity && iterator->second.Template == template_text)
+            {
+                return iterator->second;
+            }
+        }
+        auto& group = Groups.emplace(hash, Group())->second;
+        group.Severity = severity;
+        group.Template = template_text;
+        group.Tokens = std::max(ThrottleOptions.Burst, 1.0);
+        group.RefillTime = now;
+        return group;
+    }
+
+    /// Generate the summary of pending suppressed logs of the group and reset them.
+    void LogThrottle::TakeSummary(Group& group, std::vector<Summary>& summaries)
+    {
+        if (group.PendingDuplicates > 0)
+        {
+            summaries.push_back({group.Severity, "Last log repeated " + std::to_string(group.PendingDuplicates) +
+                                                 " times: " + group.LastText});
+            group.PendingDuplicates = 0;
+        }
+        if (group.PendingRateLimited > 0)
+        {
+            summaries.push_back({group.Severity, std::to_string(group.PendingRateLimited) +
+                                                 " logs suppressed by the rate limit: " + group.Template});
+            group.PendingRateLimited = 0;
+        }
+    }
+
+    /// Summarize expired windows and evict idle groups.
+    void LogThrottle::Sweep(Clock::time_point now, std::vector<Summary>& summaries)
+    {
+        if (now - SweepTime < SweepInterval) return;
+        SweepTime = now;
+        for (auto iterator = Groups.begin(); iterator != Groups.end();)
+        {
+            auto& group = iterator->second;
+            if (now - group.WindowBeginTime >= ThrottleOptions.DeduplicationWindow)
+            {
+                TakeSummary(group, summaries);
+            }
+            bool idle = now - group.WindowBeginTime >= GroupIdlePeriod && now - group.RefillTime >= GroupIdlePeriod;
+            if (idle && group.PendingDuplicates == 0 && group.PendingRateLimited == 0)
+            {
+                iterator = Groups.erase(iterator);
+                continue;
+            }
+            ++iterator;
+        }
+    }
+
+    /// Take a token from the bucket of the group.
+    bool LogThrottle::Acquire(LogSeverity severity, std::string_view template_text)
+    {
+        if (ThrottleOptions.Rate <= 0.0) return true;
+
+        auto now = Clock::now();
+        std::unique_lock lock(GroupsMutex);
+        auto& group = AcquireGroup(severity, template_text, now);
+        auto elapsed = std::chrono::duration<double>(now - group.RefillTime).count();
+        group.Tokens = std::min(std::max(ThrottleOptions.Burst, 1.0), group.Tokens + elapsed * ThrottleOptions.Rate);
+        group.RefillTime = now;
+        if (group.Tokens < 1.0)
+        {
+            ++group.PendingRateLimited;
+            ++group.RateLimitedCount;
+            RateLimitedCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        group.Tokens -= 1.0;
+        return true;
+    }
+
+    /// Check whether the log repeats the last log of its group within the deduplication window.
+    bool LogThrottle::Deduplicate(LogSeverity severity, std::string_view template_text, std::string_view text,
+                                  std::vector<Summary>& summaries)
+    {
+        auto now = Clock::now();
+        std::unique_lock lock(GroupsMutex);
+        Sweep(now, summaries);
+        auto& group = AcquireGroup(severity, template_text, now);
+        if (ThrottleOptions.DeduplicationWindow.count() > 0 &&
+            now - group.WindowBeginTime < ThrottleOptions.DeduplicationWindow && group.LastText == text)
+        {
+            ++group.PendingDuplicates;
+            ++group.DuplicateCount;
+            DuplicateCount.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        TakeSummary(group, summaries);
+        group.LastText = text;
+        group.WindowBeginTime = now;
+        return true;
+    }
+
+    /// Generate summaries of the groups whose deduplication windows have expired.
+    void LogThrottle::Sweep(std::vector<Summary>& summaries)
+    {
+        std::unique_lock lock(GroupsMutex);
+        Sweep(Clock::now(), summaries);
+    }
+
+    /// Generate summaries of all pending suppressed logs.
+    void LogThrottle::Flush(std::vector<Summary>& summaries)
+    {
+        std::unique_lock lock(GroupsMutex);
+        for (auto& [hash, group] : Groups)
+        {
+            TakeSummary(group, summaries);
+        }
+    }
+
+    /// Get suppression counts of active groups which have suppressed any log.
+    std::vector<LogThrottle::Suppression> LogThrottle::GetSuppressions()
+    {
+        std::vector<Suppression> suppressions;
+        std::unique_lock lock(GroupsMutex);
+        for (const auto& [hash, group] : Groups)
+        {
+            if (group.DuplicateCount == 0 && group.RateLimitedCount == 0) continue;
+            suppressions.push_back({group.Severity, group.Template, group.DuplicateCount, group.RateLimitedCount});
+        }
+        return suppressions;
+    }
+}
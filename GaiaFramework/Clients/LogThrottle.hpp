@@ -0,0 +1,143 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+#include "LogSeverity.hpp"
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Rate limiter and deduplicator of repeated logs.
+     * @details
+     *  Logs are grouped by their severity and template, which is the format text of a formatted log
+     *  or the text of a plain log. Every group owns a token bucket, logs beyond its rate are suppressed.
+     *  Identical logs of a group within the deduplication window are collapsed,
+     *  and a summary of the suppressed logs is generated when the group records again or its window expires.
+     */
+    class LogThrottle
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// Options of the throttle.
+        struct Options
+        {
+            /// Count of logs per second every group can record, 0 means unlimited.
+            double Rate {10.0};
+            /// Maximum count of logs every group can record in a burst.
+            double Burst {20.0};
+            /// Identical logs of a group within this window are collapsed, 0 means no deduplication.
+            std::chrono::milliseconds DeduplicationWindow {1000};
+        };
+
+        /// Summary of logs suppressed in a group.
+        struct Suppression
+        {
+            LogSeverity Severity {LogSeverity::Message};
+            /// Template of the group.
+            std::string Template;
+            /// Count of identical logs collapsed by the deduplication.
+            std::uint64_t DuplicateCount {0};
+            /// Count of logs suppressed by the rate limit.
+            std::uint64_t RateLimitedCount {0};
+        };
+
+        /// Log to record in place of suppressed logs.
+        struct Summary
+        {
+            LogSeverity Severity;
+            std::string Text;
+        };
+
+    private:
+        /// State of a group of logs.
+        struct Group
+        {
+            LogSeverity Severity {LogSeverity::Message};
+            std::string Template;
+            /// Tokens left in the bucket.
+            double Tokens {0.0};
+            /// Last time the bucket was refilled.
+            Clock::time_point RefillTime;
+            /// Text of the last recorded log.
+            std::string LastText;
+            /// Beginning of the deduplication window of the last recorded log.
+            Clock::time_point WindowBeginTime;
+            /// Identical logs collapsed since the last recorded log.
+            std::uint64_t PendingDuplicates {0};
+            /// Logs suppressed by the rate limit since the last recorded log.
+            std::uint64_t PendingRateLimited {0};
+            /// Total counts of suppressed logs of this group.
+            std::uint64_t DuplicateCount {0};
+            std::uint64_t RateLimitedCount {0};
+        };
+
+        const Options ThrottleOptions;
+
+        /// Mutex for the groups.
+        std::mutex GroupsMutex;
+        /// Groups of logs, indexed by the hash of their severities and templates, colliding groups share a hash.
+        std::unordered_multimap<std::size_t, Group> Groups;
+        /// Last time the groups were swept.
+        Clock::time_point SweepTime;
+
+        /// Total counts of suppressed logs, including groups which have been evicted.
+        std::atomic<std::uint64_t> DuplicateCount {0};
+        std::atomic<std::uint64_t> RateLimitedCount {0};
+
+        /// Find or create the group of the given severity and template.
+        Group& AcquireGroup(LogSeverity severity, std::string_view template_text, Clock::time_point now);
+        /// Generate the summary of pending suppressed logs of the group and reset them.
+        static void TakeSummary(Group& group, std::vector<Summary>& summaries);
+        /// Summarize expired windows and evict idle groups.
+        void Sweep(Clock::time_point now, std::vector<Summary>& summaries);
+
+    public:
+        explicit LogThrottle(const Options& options);
+
+        /**
+         * @brief Take a token from the bucket of the group.
+         * @retval true The log can be recorded.
+         * @retval false The log is suppressed by the rate limit, its text does not need to be generated.
+         */
+        bool Acquire(LogSeverity severity, std::string_view template_text);
+
+        /**
+         * @brief Check whether the log repeats the last log of its group within the deduplication window.
+         * @param summaries Summaries of previously suppressed logs to record before this log.
+         * @retval true The log should be recorded.
+         * @retval false The log is collapsed into the last one.
+         */
+        bool Deduplicate(LogSeverity severity, std::string_view template_text, std::string_view text,
+                         std::vector<Summary>& summaries);
+
+        /**
+         * @brief Generate summaries of the groups whose deduplication windows have expired.
+         * @details It should be invoked regularly, otherwise summaries only appear when their groups record again.
+         */
+        void Sweep(std::vector<Summary>& summaries);
+
+        /// Generate summaries of all pending suppressed logs.
+        void Flush(std::vector<Summary>& summaries);
+
+        /// Get the total count of identical logs collapsed by the deduplication.
+        [[nodiscard]] inline std::uint64_t GetDuplicateCount() const noexcept
+        {
+            return DuplicateCount.load(std::memory_order_relaxed);
+        }
+        /// Get the total count of logs suppressed by the rate limit.
+        [[nodiscard]] inline std::uint64_t GetRateLimitedCount() const noexcept
+        {
+            return RateLimitedCount.load(std::memory_order_relaxed);
+        }
+        /// Get suppression counts of active groups which have suppressed any log.
+        std::vector<Suppression> GetSuppressions();
+    };
+}
@@ -3,31 +3,95 @@
 #include <thread>
 #include <chrono>
 #include <utility>
+#include <algorithm>
+#include <iterator>
+#include <list>
+#include <vector>
 
 namespace Gaia::Framework::Clients
 {
+    /// Count of heartbeats between two full synchronizations of the local mirror.
+    static constexpr unsigned int SynchronizationHeartbeats = 30;
+
+    /**
+     * @brief Remove the given names from the registry if they are still expired.
+     * @details KEYS are the registry and the addresses hash, ARGV are the current time and the names.
+     */
+    static constexpr const char* RemoveExpiredNamesScript = R"(
+local removed_count = 0
+for index = 2, #ARGV do
+    local expiration_time = redis.call('ZSCORE', KEYS[1], ARGV[index])
+    if expiration_time and tonumber(expiration_time) <= tonumber(ARGV[1]) then
+        redis.call('ZREM', KEYS[1], ARGV[index])
+        redis.call('HDEL', KEYS[2], ARGV[index])
+        removed_count = removed_count + 1
+    end
+end
+return removed_count
+)";
     /// Construct and connect to the Redis server on the given address.
     NameClient::NameClient(unsigned int port, const std::string &ip) :
         NameClient(std::make_shared<sw::redis::Redis>("tcp://" + ip + ":" + std::to_string(port)))
     {}
 
     /// Reuse the connection to a Redis server.
-    NameClient::NameClient(std::shared_ptr<sw::redis::Redis> connection) : Connection(std::move(connection))
+    NameClient::NameClient(std::shared_ptr<sw::redis::Redis> connection) : Connection(std::move(connection)),
+        Heartbeater([this](const std::atomic_bool& life_flag){
+            this->SendHeartbeats(life_flag);
+        })
     {}
 
+    /// Stop the background heartbeat.
+    NameClient::~NameClient()
+    {
+        StopHeartbeat();
+    }
+
+    /// Get the expiration time of names refreshed now.
+    std::int64_t NameClient::GetExpirationTime() const
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch() + NameTimeToLive).count();
+    }
+
+    /// Get the current time in milliseconds since the epoch.
+    static std::int64_t GetCurrentTime()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
     /// Get all registered names.
     std::unordered_set<std::string> NameClient::GetNames()
     {
-        unsigned long long cursor = 0;
+        std::unordered_set<std::string> names;
+
+        if (MirrorMode)
+        {
+            auto current_time = GetCurrentTime();
+            std::shared_lock lock(DirectoryMutex);
+            for (const auto& [name, expiration_time] : Directory)
+            {
+                if (expiration_time > current_time) names.insert(name);
+            }
+            return names;
+        }
+        if (RegistryMode)
+        {
+            Connection->zrangebyscore(RegistryKey,
+                                      sw::redis::LeftBoundedInterval<double>(
+                                              static_cast<double>(GetCurrentTime()), sw::redis::BoundType::OPEN),
+                                      std::inserter(names, names.end()));
+            return names;
+        }
 
+        long long cursor = 0;
         std::list<std::string> results;
         do
         {
-            cursor = Connection->scan(0, "names/*", results.end());
+            cursor = Connection->scan(cursor, "names/*", 1000, std::back_inserter(results));
         }while (cursor != 0);
 
-        std::unordered_set<std::string> names;
-
         // Remove prefix "names/"
         for (const auto& result : results)
         {
@@ -40,7 +104,25 @@ namespace Gaia::Framework::Clients
     /// Activate a name.
     void NameClient::RegisterName(const std::string &name, const std::string& address)
     {
-        Connection->set("names/" + name, address, std::chrono::seconds(3));
+        if (RegistryMode)
+        {
+            auto expiration_time = GetExpirationTime();
+            auto pipeline = Connection->pipeline();
+            pipeline.set("names/" + name, address, NameTimeToLive)
+                .zadd(RegistryKey, name, static_cast<double>(expiration_time))
+                .hset(AddressesKey, name, address)
+                .publish(EventsChannel, "+" + name + "@" + std::to_string(expiration_time))
+                .exec();
+            if (MirrorMode)
+            {
+                std::unique_lock lock(DirectoryMutex);
+                Directory.insert_or_assign(name, expiration_time);
+            }
+        }
+        else
+        {
+            Connection->set("names/" + name, address, NameTimeToLive);
+        }
         std::unique_lock lock(NamesMutex);
         Names.emplace(name, address);
     }
@@ -48,43 +130,321 @@ namespace Gaia::Framework::Clients
     /// Deactivate a name.
     void NameClient::UnregisterName(const std::string &name)
     {
-        Connection->del("names/" + name);
+        if (RegistryMode)
+        {
+            auto pipeline = Connection->pipeline();
+            pipeline.del("names/" + name)
+                .zrem(RegistryKey, name)
+                .hdel(AddressesKey, name)
+                .publish(EventsChannel, "-" + name)
+                .exec();
+            if (MirrorMode)
+            {
+                std::unique_lock lock(DirectoryMutex);
+                Directory.erase(name);
+            }
+        }
+        else
+        {
+            Connection->del("names/" + name);
+        }
         std::unique_lock lock(NamesMutex);
         Names.erase(name);
     }
 
-    /// Update the timestamp of a name to keep it valid.
-    void NameClient::UpdateName(const std::string& name, const std::string& address)
+    /// Keep names in a dedicated registry instead of scanning the whole keyspace.
+    void NameClient::EnableRegistry(bool mirror)
     {
-        if (Connection->exists(name))
+        RegistryMode = true;
+        MirrorMode = mirror;
+        if (mirror)
         {
-            Connection->expire("names/" + name, std::chrono::seconds(2));
+            SynchronizeDirectory();
         }
-        else
+    }
+
+    /// Reload the local mirror from the registry, and remove expired names from the registry.
+    void NameClient::SynchronizeDirectory()
+    {
+        auto current_time = GetCurrentTime();
+        std::vector<std::pair<std::string, double>> entries;
+        Connection->zrangebyscore(RegistryKey, sw::redis::UnboundedInterval<double>{},
+                                  std::back_inserter(entries));
+
+        std::unordered_map<std::string, std::int64_t> directory;
+        std::vector<std::string> expired_names;
+        for (auto& [name, score] : entries)
+        {
+            auto expiration_time = static_cast<std::int64_t>(score);
+            if (expiration_time > current_time)
+            {
+                directory.emplace(std::move(name), expiration_time);
+            }
+            else
+            {
+                expired_names.push_back(std::move(name));
+            }
+        }
+
+        if (!expired_names.empty())
         {
-            Connection->set("names/" + name, address), std::chrono::seconds(2);
+            // The script checks the expiration again, so names refreshed after they were read are kept.
+            std::vector<std::string> keys {RegistryKey, AddressesKey};
+            std::vector<std::string> arguments;
+            arguments.reserve(expired_names.size() + 1);
+            arguments.push_back(std::to_string(current_time));
+            std::move(expired_names.begin(), expired_names.end(), std::back_inserter(arguments));
+            Connection->eval<long long>(RemoveExpiredNamesScript, keys.begin(), keys.end(),
+                                        arguments.begin(), arguments.end());
         }
+
+        if (!MirrorMode) return;
+        std::unique_lock lock(DirectoryMutex);
+        // Keep registrations which arrived as events after the registry was read.
+        for (const auto& [name, expiration_time] : Directory)
+        {
+            if (expiration_time > current_time)
+            {
+                auto& synchronized_time = directory[name];
+                synchronized_time = std::max(synchronized_time, expiration_time);
+            }
+        }
+        Directory.swap(directory);
+    }
+
+    /// Update the local mirror and the resolver cache with an event from the events channel.
+    void NameClient::HandleEvent(const std::string& message)
+    {
+        if (message.size() < 2) return;
+
+        if (message.front() == '-')
+        {
+            auto name = message.substr(1);
+            InvalidateResolution(name);
+            if (!MirrorMode) return;
+            std::unique_lock lock(DirectoryMutex);
+            Directory.erase(name);
+            return;
+        }
+        // Heartbeats only extend expiration times, so cached resolutions stay valid.
+        bool is_refresh = message.front() == '*';
+        if (message.front() != '+' && !is_refresh) return;
+        auto separator_index = message.find_last_of('@');
+        if (separator_index == std::string::npos || separator_index < 2) return;
+        // A registered name may have been cached as absent, or with its old address.
+        if (!is_refresh) InvalidateResolution(message.substr(1, separator_index - 1));
+        if (!MirrorMode) return;
+        std::int64_t expiration_time = 0;
+        try
+        {
+            expiration_time = std::stoll(message.substr(separator_index + 1));
+        }
+        catch (std::exception& error)
+        {
+            return;
+        }
+        std::unique_lock lock(DirectoryMutex);
+        auto& directory_time = Directory[message.substr(1, separator_index - 1)];
+        directory_time = std::max(directory_time, expiration_time);
     }
 
     /// Get the address text of the given name.
     std::string NameClient::QueryAddress(const std::string &name)
     {
-        return Connection->get(name).value_or("");
+        return ResolveName(name).value_or("");
+    }
+
+    /// Resolve the address of a name, std::nullopt if it does not exist.
+    std::optional<std::string> NameClient::ResolveName(const std::string& name)
+    {
+        if (!ResolverCacheEnabled.load(std::memory_order_relaxed))
+        {
+            return Connection->get("names/" + name);
+        }
+
+        std::shared_lock shared_lock(ResolverMutex);
+        auto finder = ResolverCache.find(name);
+        if (finder != ResolverCache.end() && finder->second.ExpirationTime > std::chrono::steady_clock::now())
+        {
+            ResolverHitCount.fetch_add(1, std::memory_order_relaxed);
+            return finder->second.Address;
+        }
+        shared_lock.unlock();
+
+        ResolverMissCount.fetch_add(1, std::memory_order_relaxed);
+        auto generation = ResolverGeneration.load();
+        auto address = Connection->get("names/" + name);
+        auto expiration_time = std::chrono::steady_clock::now() +
+                (address.has_value() ? PositiveTimeToLive : NegativeTimeToLive);
+
+        std::unique_lock lock(ResolverMutex);
+        if (ResolverGeneration.load() == generation && ResolverCacheEnabled.load())
+        {
+            ResolverCache.insert_or_assign(name, ResolvedName{address, expiration_time});
+        }
+        return address;
+    }
+
+    /// Remove the cached resolution result of a name.
+    void NameClient::InvalidateResolution(const std::string& name)
+    {
+        if (!ResolverCacheEnabled.load(std::memory_order_relaxed)) return;
+        std::unique_lock lock(ResolverMutex);
+        ++ResolverGeneration;
+        ResolverCache.erase(name);
+    }
+
+    /// Cache results of address queries and validity checks.
+    void NameClient::EnableResolverCache(std::chrono::milliseconds positive_ttl,
+                                         std::chrono::milliseconds negative_ttl)
+    {
+        std::unique_lock lock(ResolverMutex);
+        ++ResolverGeneration;
+        ResolverCache.clear();
+        PositiveTimeToLive = positive_ttl;
+        NegativeTimeToLive = negative_ttl;
+        ResolverCacheEnabled = true;
+    }
+
+    /// Disable and clear the resolver cache.
+    void NameClient::DisableResolverCache()
+    {
+        std::unique_lock lock(ResolverMutex);
+        ResolverCacheEnabled = false;
+        ++ResolverGeneration;
+        ResolverCache.clear();
     }
 
     /// Update names in the update list.
-    void NameClient::Update()
+    bool NameClient::Update()
     {
-        std::shared_lock lock(NamesMutex);
-        for (const auto& [name, address] : Names)
+        std::unique_lock heartbeat_lock(HeartbeatMutex);
+        auto begin_time = std::chrono::steady_clock::now();
+        try
         {
-            UpdateName(name, address);
+            if (!HeartbeatPipeline)
+            {
+                HeartbeatPipeline = std::make_unique<sw::redis::Pipeline>(Connection->pipeline());
+            }
+            std::shared_lock names_lock(NamesMutex);
+            if (Names.empty()) return true;
+            // SET with an expiration both refreshes existing names and restores expired ones.
+            auto expiration_time = GetExpirationTime();
+            auto expiration_text = "@" + std::to_string(expiration_time);
+            bool registry_mode = RegistryMode;
+            for (const auto& [name, address] : Names)
+            {
+                HeartbeatPipeline->set("names/" + name, address, NameTimeToLive);
+                if (registry_mode)
+                {
+                    // Mirrors learn the refreshed expiration time from the event instead of reading the registry.
+                    HeartbeatPipeline->zadd(RegistryKey, name, static_cast<double>(expiration_time))
+                        .hset(AddressesKey, name, address)
+                        .publish(EventsChannel, "*" + name + expiration_text);
+                }
+            }
+            names_lock.unlock();
+            HeartbeatPipeline->exec();
         }
+        catch (sw::redis::Error& error)
+        {
+            // The pipeline connection may be broken, it will be recreated for the next heartbeat.
+            HeartbeatPipeline.reset();
+            ++Statistics.HeartbeatCount;
+            ++Statistics.FailureCount;
+            return false;
+        }
+
+        auto latency = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - begin_time);
+        ++Statistics.HeartbeatCount;
+        TotalLatency += latency;
+        Statistics.LastLatency = latency;
+        Statistics.MaxLatency = std::max(Statistics.MaxLatency, latency);
+        Statistics.AverageLatency = TotalLatency /
+                static_cast<long>(Statistics.HeartbeatCount - Statistics.FailureCount);
+        return true;
+    }
+
+    /// Send heartbeats of registered names on a background thread.
+    void NameClient::StartHeartbeat(std::chrono::milliseconds interval, double ttl_ratio)
+    {
+        StopHeartbeat();
+        HeartbeatInterval = std::max(interval, std::chrono::milliseconds(1));
+        NameTimeToLive = std::chrono::milliseconds(static_cast<long>(
+                static_cast<double>(HeartbeatInterval.count()) * std::max(ttl_ratio, 1.0)));
+        HeartbeatRunning = true;
+        Heartbeater.Start();
+    }
+
+    /// Stop the background heartbeat.
+    void NameClient::StopHeartbeat()
+    {
+        if (!HeartbeatRunning.exchange(false)) return;
+        Heartbeater.Stop();
+    }
+
+    /// Send heartbeats at the interval until the life flag is false.
+    void NameClient::SendHeartbeats(const std::atomic_bool& life_flag)
+    {
+        auto heartbeat_time = std::chrono::steady_clock::now();
+        unsigned int heartbeats_to_synchronization = 0;
+        while (life_flag.load())
+        {
+            if (!Update())
+            {
+                // Events may have been lost while the connection was broken.
+                heartbeats_to_synchronization = 0;
+            }
+            else if (MirrorMode && heartbeats_to_synchronization-- == 0)
+            {
+                try
+                {
+                    SynchronizeDirectory();
+                    heartbeats_to_synchronization = SynchronizationHeartbeats;
+                }
+                catch (sw::redis::Error&)
+                {
+                    heartbeats_to_synchronization = 0;
+                }
+            }
+            heartbeat_time += HeartbeatInterval;
+            // Skip missed heartbeats instead of sending them in a burst.
+            auto now = std::chrono::steady_clock::now();
+            if (heartbeat_time < now) heartbeat_time = now;
+            while (life_flag.load() && std::chrono::steady_clock::now() < heartbeat_time)
+            {
+                std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(
+                        std::chrono::milliseconds(100), heartbeat_time - std::chrono::steady_clock::now()));
+            }
+        }
+    }
+
+    /// Get the statistics of heartbeats.
+    NameClient::HeartbeatStatistics NameClient::GetHeartbeatStatistics()
+    {
+        std::unique_lock lock(HeartbeatMutex);
+        return Statistics;
     }
 
     /// Check whether a name is valid or not.
     bool NameClient::IsNameValid(const std::string &name)
     {
-        return Connection->exists(name);
+        if (MirrorMode)
+        {
+            std::shared_lock lock(DirectoryMutex);
+            auto finder = Directory.find(name);
+            return finder != Directory.end() && finder->second > GetCurrentTime();
+        }
+        if (RegistryMode)
+        {
+            auto expiration_time = Connection->zscore(RegistryKey, name);
+            return expiration_time.has_value() && static_cast<std::int64_t>(*expiration_time) > GetCurrentTime();
+        }
+        if (ResolverCacheEnabled.load(std::memory_order_relaxed))
+        {
+            return ResolveName(name).has_value();
+        }
+        return Connection->exists("names/" + name) > 0;
     }
 }
\ No newline at end of file
@@ -7,7 +7,12 @@
 #include <atomic>
 #include <shared_mutex>
 #include <chrono>
+#include <mutex>
+#include <cstdint>
+#include <unordered_map>
+#include <optional>
 #include <sw/redis++/redis++.h>
+#include <GaiaBackground/GaiaBackground.hpp>
 
 namespace Gaia::Framework::Clients
 {
@@ -22,16 +27,106 @@ namespace Gaia::Framework::Clients
         /// Connection to Redis server, default address is '127.0.0.1:6379'
         std::shared_ptr<sw::redis::Redis> Connection;
 
-    private:
-        /// Update the timestamp of a name to keep it valid.
-        void UpdateName(const std::string& name, const std::string& address);
+    public:
+        /// Statistics of heartbeats.
+        struct HeartbeatStatistics
+        {
+            /// Count of sent heartbeats.
+            std::uint64_t HeartbeatCount {0};
+            /// Count of heartbeats which failed.
+            std::uint64_t FailureCount {0};
+            /// Round trip time of the last heartbeat.
+            std::chrono::microseconds LastLatency {0};
+            /// Average round trip time of heartbeats.
+            std::chrono::microseconds AverageLatency {0};
+            /// Maximum round trip time of heartbeats.
+            std::chrono::microseconds MaxLatency {0};
+        };
 
+    private:
         /// Mutex for names list.
         std::shared_mutex NamesMutex;
         /// Names to update.
         std::unordered_map<std::string, std::string> Names;
 
+        /// Interval between two heartbeats.
+        std::chrono::milliseconds HeartbeatInterval {1000};
+        /// Names expire after this time without heartbeats.
+        std::chrono::milliseconds NameTimeToLive {3000};
+
+        /// Pipeline to send heartbeats, recreated after failures.
+        std::unique_ptr<sw::redis::Pipeline> HeartbeatPipeline;
+        /// Mutex for the heartbeat pipeline and statistics.
+        std::mutex HeartbeatMutex;
+        /// Statistics of heartbeats.
+        HeartbeatStatistics Statistics;
+        /// Total round trip time of heartbeats, used to compute the average.
+        std::chrono::microseconds TotalLatency {0};
+
+        /// Send heartbeats at the interval until the life flag is false.
+        void SendHeartbeats(const std::atomic_bool& life_flag);
+
+        /// Background worker which sends heartbeats.
+        Gaia::Background::BackgroundWorker Heartbeater;
+        /// Whether the background heartbeat is running or not.
+        std::atomic_bool HeartbeatRunning {false};
+
+        /// Whether names are kept in the registry sorted set or not.
+        std::atomic_bool RegistryMode {false};
+        /// Whether the local mirror of the name directory is maintained or not.
+        std::atomic_bool MirrorMode {false};
+        /// Mutex for the local directory.
+        std::shared_mutex DirectoryMutex;
+        /// Local mirror of the registry, maps names to their expiration time in milliseconds since the epoch.
+        std::unordered_map<std::string, std::int64_t> Directory;
+
+        /// Get the expiration time of names refreshed now, in milliseconds since the epoch.
+        [[nodiscard]] std::int64_t GetExpirationTime() const;
+
+        /// Resolution result of a name in the resolver cache.
+        struct ResolvedName
+        {
+            /// Address of the name, std::nullopt if the name does not exist.
+            std::optional<std::string> Address;
+            /// The result is discarded after this time point.
+            std::chrono::steady_clock::time_point ExpirationTime;
+        };
+
+        /// Whether name resolutions are cached or not.
+        std::atomic_bool ResolverCacheEnabled {false};
+        /// Time to live of cached addresses of existing names.
+        std::chrono::milliseconds PositiveTimeToLive {1000};
+        /// Time to live of cached results of absent names.
+        std::chrono::milliseconds NegativeTimeToLive {100};
+        /// Mutex for the resolver cache.
+        std::shared_mutex ResolverMutex;
+        /// Cached resolution results.
+        std::unordered_map<std::string, ResolvedName> ResolverCache;
+        /// Increased by every invalidation, results fetched before an invalidation will not be cached.
+        std::atomic<std::uint64_t> ResolverGeneration {0};
+        /// Count of resolutions answered by the cache.
+        std::atomic<std::uint64_t> ResolverHitCount {0};
+        /// Count of resolutions which queried the Redis server.
+        std::atomic<std::uint64_t> ResolverMissCount {0};
+
+        /// Resolve the address of a name, std::nullopt if it does not exist.
+        std::optional<std::string> ResolveName(const std::string& name);
+        /// Remove the cached resolution result of a name.
+        void InvalidateResolution(const std::string& name);
+
     public:
+        /// Sorted set of registered names, scored by their expiration time in milliseconds since the epoch.
+        static constexpr const char* RegistryKey = "registry/names";
+        /// Hash which maps registered names to their addresses.
+        static constexpr const char* AddressesKey = "registry/addresses";
+        /**
+         * @brief Channel of registry events.
+         * @details
+         *  Messages are "+<name>@<expiration time>" for registrations, "*<name>@<expiration time>" for heartbeats
+         *  which extend the expiration time, and "-<name>" for removals.
+         */
+        static constexpr const char* EventsChannel = "registry/events";
+
         /**
          * @brief Construct and try to connect to the Redis server on the given address.
          * @param port The port of the redis server.
@@ -41,10 +136,14 @@ namespace Gaia::Framework::Clients
         /// Reuse the connection to a Redis server.
         explicit NameClient(std::shared_ptr<sw::redis::Redis> connection);
 
+        /// Stop the background heartbeat.
+        ~NameClient();
+
         /**
          * @brief Query all registered names.
          * @return Set of valid names which have not been expired yet.
-         * @attention This is a time consuming function.
+         * @attention This is a time consuming function without the registry mode,
+         *            which scans the whole keyspace.
          */
         std::unordered_set<std::string> GetNames();
 
@@ -52,7 +151,7 @@ namespace Gaia::Framework::Clients
          * @brief Query whether a name is valid or not.
          * @retval true The given name is online.
          * @retval false The given name does not exist.
-         * @attention This is a time consuming function.
+         * @details It is a local lookup in the registry mode with the local mirror.
          */
         bool IsNameValid(const std::string& name);
 
@@ -69,13 +168,83 @@ namespace Gaia::Framework::Clients
          */
         void UnregisterName(const std::string& name);
 
-        /// Update the expiration time of names in the update list.
-        void Update();
+        /**
+         * @brief Update the expiration time of names in the update list.
+         * @details All names are refreshed by one pipeline, which costs a single round trip.
+         * @retval true The heartbeat is sent.
+         * @retval false The heartbeat failed.
+         */
+        bool Update();
+
+        /**
+         * @brief Send heartbeats of registered names on a background thread.
+         * @param interval Interval between two heartbeats.
+         * @param ttl_ratio Names expire after this multiple of the interval without heartbeats,
+         *                  values below 1 are treated as 1.
+         */
+        void StartHeartbeat(std::chrono::milliseconds interval = std::chrono::milliseconds(1000),
+                            double ttl_ratio = 3.0);
+        /// Stop the background heartbeat, registered names will expire after their time to live.
+        void StopHeartbeat();
+
+        /// Get the statistics of heartbeats.
+        [[nodiscard]] HeartbeatStatistics GetHeartbeatStatistics();
+
+        /**
+         * @brief Keep names in a dedicated registry instead of scanning the whole keyspace.
+         * @param mirror Whether to keep a local mirror of the registry or not.
+         * @details
+         *  Names are kept in a sorted set scored by their expiration time, and their addresses in a hash.
+         *  Name keys are still written, so clients without the registry mode can resolve these names.
+         *  With the local mirror, GetNames() and IsNameValid() are local lookups.
+         *  The mirror is updated by events passed to HandleEvent(), including the refreshed expiration times
+         *  published by heartbeats. It is fully synchronized with the registry only every few dozen heartbeats
+         *  and after failed heartbeats, to recover from lost events and to remove expired names.
+         *  Enable the registry before registering names, so their registrations are published.
+         */
+        void EnableRegistry(bool mirror = true);
+        /// Check whether names are kept in the registry or not.
+        [[nodiscard]] inline bool IsRegistryMode() const noexcept
+        {
+            return RegistryMode.load();
+        }
+        /**
+         * @brief Reload the local mirror from the registry, and remove expired names from the registry.
+         * @attention The cost is proportional to the count of registered names.
+         */
+        void SynchronizeDirectory();
+        /**
+         * @brief Update the local mirror and the resolver cache with an event from EventsChannel.
+         * @param message Content of the event.
+         */
+        void HandleEvent(const std::string& message);
+
+        /**
+         * @brief Cache results of QueryAddress() and IsNameValid().
+         * @param positive_ttl Time to live of cached addresses of existing names.
+         * @param negative_ttl Time to live of cached results of absent names.
+         * @details Cached results are invalidated by events passed to HandleEvent().
+         */
+        void EnableResolverCache(std::chrono::milliseconds positive_ttl = std::chrono::milliseconds(1000),
+                                 std::chrono::milliseconds negative_ttl = std::chrono::milliseconds(100));
+        /// Disable and clear the resolver cache.
+        void DisableResolverCache();
+        /// Get the count of resolutions answered by the cache.
+        [[nodiscard]] inline std::uint64_t GetResolverHitCount() const noexcept
+        {
+            return ResolverHitCount.load(std::memory_order_relaxed);
+        }
+        /// Get the count of resolutions which queried the Redis server.
+        [[nodiscard]] inline std::uint64_t GetResolverMissCount() const noexcept
+        {
+            return ResolverMissCount.load(std::memory_order_relaxed);
+        }
 
         /**
          * @brief Query the address text of the given name.
          * @param name The name to query.
          * @return The address text of given name, maybe empty.
+         * @details It is a local lookup when the result is in the resolver cache.
          */
         std::string QueryAddress(const std::string& name);
     };
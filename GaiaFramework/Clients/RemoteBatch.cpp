@@ -0,0 +1,72 @@
+#include "RemoteBatch.hpp"
+
+namespace Gaia::Framework::Clients
+{
+    /// Bind the connection.
+    RemoteBatch::RemoteBatch(std::shared_ptr<sw::redis::Redis> connection) : Connection(std::move(connection))
+    {}
+
+    /// Get the pipeline, and create it if it does not exist.
+    sw::redis::Pipeline& RemoteBatch::AcquirePipeline()
+    {
+        if (!Pipeline)
+        {
+            Pipeline = std::make_unique<sw::redis::Pipeline>(Connection->pipeline());
+        }
+        return *Pipeline;
+    }
+
+    /// Get the reply text of an operation in the given round.
+    const std::optional<std::string>* RemoteBatch::GetReplyText(std::size_t index, std::uint64_t round) const
+    {
+        if (round + 1 != ExecutedRounds || index >= ReplyTexts.size()) return nullptr;
+        return &ReplyTexts[index];
+    }
+
+    /// Queue an operation to check whether a remote value exists or not.
+    RemoteBatch::Reply<bool> RemoteBatch::Has(const std::string& name)
+    {
+        if (!Connection) return {};
+        AcquirePipeline().exists(name);
+        Operations.push_back(OperationType::Has);
+        return {this, Operations.size() - 1, ExecutedRounds};
+    }
+
+    /// Send all queued operations in one round trip and receive their replies.
+    void RemoteBatch::Execute()
+    {
+        ++ExecutedRounds;
+        ReplyTexts.clear();
+        if (Operations.empty()) return;
+
+        auto operations = std::move(Operations);
+        Operations.clear();
+        try
+        {
+            auto replies = Pipeline->exec();
+            ReplyTexts.reserve(operations.size());
+            for (std::size_t index = 0; index < operations.size(); ++index)
+            {
+                switch (operations[index])
+                {
+                    case OperationType::Set:
+                        ReplyTexts.emplace_back(replies.get<bool>(index) ? "1" : "0");
+                        break;
+                    case OperationType::Get:
+                        ReplyTexts.emplace_back(replies.get<sw::redis::OptionalString>(index));
+                        break;
+                    case OperationType::Has:
+                        ReplyTexts.emplace_back(replies.get<long long>(index) > 0 ? "1" : "0");
+                        break;
+                }
+            }
+        }
+        catch (sw::redis::Error&)
+        {
+            // The pipeline connection may be broken, it will be recreated for the next round.
+            Pipeline.reset();
+            ReplyTexts.clear();
+            throw;
+        }
+    }
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include <sw/redis++/redis++.h>
+
+#include "../Codecs/TextCodec.hpp"
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Batch of remote value operations sent in one pipeline.
+     * @details
+     *  Operations are queued by Set(), Get() and Has(), and sent together by Execute(),
+     *  which costs a single round trip however many operations are queued.
+     *  Values are converted by Codecs::TextCodec, the same as Service::SetRemoteValue() and GetRemoteValue().
+     *  The pipeline owns a connection of its own, so a batch should be kept and reused for repeated rounds.
+     *  A batch is not thread-safe.
+     */
+    class RemoteBatch
+    {
+    public:
+        /**
+         * @brief Handle of the reply to a queued operation.
+         * @tparam ValueType Type of the value in the reply.
+         * @details It is valid until the next round of the batch is executed.
+         */
+        template <typename ValueType>
+        class Reply
+        {
+            friend class RemoteBatch;
+
+        private:
+            const RemoteBatch* Batch {nullptr};
+            std::size_t Index {0};
+            std::uint64_t Round {0};
+
+            Reply(const RemoteBatch* batch, std::size_t index, std::uint64_t round) noexcept :
+                Batch(batch), Index(index), Round(round)
+            {}
+
+        public:
+            Reply() = default;
+
+            /**
+             * @brief Get the value of the reply.
+             * @return std::nullopt if the value does not exist or can not be parsed,
+             *         or if the round of this reply has not been executed or has been replaced.
+             */
+            [[nodiscard]] std::optional<ValueType> Get() const
+            {
+                if (!Batch) return std::nullopt;
+                const auto* text = Batch->GetReplyText(Index, Round);
+                if (!text || !text->has_value()) return std::nullopt;
+                return Codecs::DecodeText<ValueType>(**text);
+            }
+        };
+
+    private:
+        /// Connection to the Redis server.
+        std::shared_ptr<sw::redis::Redis> Connection;
+        /// Pipeline of the batch, created on the first operation and recreated after failures.
+        std::unique_ptr<sw::redis::Pipeline> Pipeline;
+
+        /// Kinds of queued operations, which decide how their replies are read.
+        enum class OperationType : std::uint8_t
+        {
+            Set,
+            Get,
+            Has
+        };
+        /// Operations queued in the current round.
+        std::vector<OperationType> Operations;
+        /// Replies of the last executed round, in the order of their operations.
+        std::vector<std::optional<std::string>> ReplyTexts;
+        /// Count of executed rounds.
+        std::uint64_t ExecutedRounds {0};
+
+        /// Get the pipeline, and create it if it does not exist.
+        sw::redis::Pipeline& AcquirePipeline();
+        /// Get the reply text of an operation in the given round, null if it is not available.
+        [[nodiscard]] const std::optional<std::string>* GetReplyText(std::size_t index, std::uint64_t round) const;
+
+    public:
+        /// Bind the connection, operations are ignored if it is null.
+        explicit RemoteBatch(std::shared_ptr<sw::redis::Redis> connection);
+
+        /**
+         * @brief Queue an operation to set a remote value.
+         * @param name Name of the value.
+         * @param value Value to set.
+         * @param time_to_live The value expires after this time, it does not expire if it is 0.
+         * @return This batch, to chain operations.
+         */
+        template <typename ValueType>
+        RemoteBatch& Set(const std::string& name, const ValueType& value,
+                         std::chrono::milliseconds time_to_live = std::chrono::milliseconds(0))
+        {
+            if (!Connection) return *this;
+            AcquirePipeline().set(name, Codecs::EncodeText(value), time_to_live);
+            Operations.push_back(OperationType::Set);
+            return *this;
+        }
+
+        /**
+         * @brief Queue an operation to get a remote value.
+         * @return Handle of the value, available after Execute().
+         */
+        template <typename ValueType>
+        Reply<ValueType> Get(const std::string& name)
+        {
+            if (!Connection) return {};
+            AcquirePipeline().get(name);
+            Operations.push_back(OperationType::Get);
+            return {this, Operations.size() - 1, ExecutedRounds};
+        }
+
+        /**
+         * @brief Queue an operation to check whether a remote value exists or not.
+         * @return Handle of the existence, available after Execute().
+         */
+        Reply<bool> Has(const std::string& name);
+
+        /// Get the count of operations queued in the current round.
+        [[nodiscard]] inline std::size_t GetSize() const noexcept
+        {
+            return Operations.size();
+        }
+
+        /**
+         * @brief Send all queued operations in one round trip and receive their replies.
+         * @details
+         *  Replies of the previous round are replaced.
+         *  If the round fails, the pipeline is recreated for the next round, and the error is thrown.
+         */
+        void Execute();
+    };
+}
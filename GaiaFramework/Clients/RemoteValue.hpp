@@ -0,0 +1,75 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <memory>
+#include <type_traits>
+
+#include "RemoteValueFlusher.hpp"
+#include "../Codecs/TextCodec.hpp"
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Handle of a remote value which is written by a background flusher.
+     * @tparam ValueType Type of the value, converted to text by Codecs::TextCodec.
+     * @details
+     *  Set() only buffers the value in memory, so it can be invoked at any rate;
+     *  the flusher writes the latest value at most once per interval of the handle,
+     *  or at once when a numeric value changes beyond the threshold of the handle.
+     *  The last value is still written after the handle is destroyed.
+     *  Copies of a handle share the same buffer, and handles are thread-safe.
+     *  Handles must not outlive the flusher which creates them.
+     */
+    template <typename ValueType>
+    class RemoteValue
+    {
+    private:
+        /// Buffer of the value, null if the handle is empty.
+        std::shared_ptr<RemoteValueFlusher::Slot> Slot;
+
+    public:
+        /// Construct an empty handle, values set to it are discarded.
+        RemoteValue() = default;
+        /// Bind the slot of the value.
+        explicit RemoteValue(std::shared_ptr<RemoteValueFlusher::Slot> slot) : Slot(std::move(slot))
+        {}
+
+        /// Buffer a value, it replaces the buffered value which has not been written.
+        void Set(const ValueType& value)
+        {
+            if (!Slot) return;
+            std::optional<double> number;
+            if constexpr (std::is_arithmetic_v<ValueType>)
+            {
+                number = static_cast<double>(value);
+            }
+            Slot->Update(Codecs::EncodeText(value), number);
+        }
+
+        /// Buffer a value.
+        RemoteValue& operator=(const ValueType& value)
+        {
+            Set(value);
+            return *this;
+        }
+
+        /// Write the buffered value in the next flush regardless of the interval.
+        void Flush()
+        {
+            if (Slot) Slot->Flush();
+        }
+
+        /// Get the name of the remote value, empty if the handle is empty.
+        [[nodiscard]] std::string GetName() const
+        {
+            return Slot ? Slot->GetName() : std::string();
+        }
+
+        /// Check whether the handle is bound to a remote value or not.
+        [[nodiscard]] explicit operator bool() const noexcept
+        {
+            return static_cast<bool>(Slot);
+        }
+    };
+}
@@ -0,0 +1,136 @@
+#include "RemoteValueCache.hpp"
+#include <mutex>
+#include <vector>
+
+namespace Gaia::Framework::Clients
+{
+    /// Bind the connection and the function to subscribe keyspace channels.
+    RemoteValueCache::RemoteValueCache(std::shared_ptr<sw::redis::Redis> connection, SubscribeFunction subscribe,
+                                       std::size_t capacity, unsigned int database) :
+        Connection(std::move(connection)),
+        ChannelPrefix("__keyspace@" + std::to_string(database) + "__:"),
+        Capacity(capacity), Subscribe(std::move(subscribe))
+    {}
+
+    /// Get the text of a remote value, from memory if it is cached.
+    std::optional<std::string> RemoteValueCache::Get(const std::string& name)
+    {
+        std::shared_lock shared_lock(EntriesMutex);
+        auto finder = Entries.find(name);
+        if (finder != Entries.end() && finder->second.Valid)
+        {
+            HitCount.fetch_add(1, std::memory_order_relaxed);
+            return finder->second.Text;
+        }
+        bool is_new = finder == Entries.end();
+        std::uint64_t generation = is_new ? 0 : finder->second.Generation;
+        shared_lock.unlock();
+
+        MissCount.fetch_add(1, std::memory_order_relaxed);
+        if (is_new)
+        {
+            std::unique_lock lock(EntriesMutex);
+            if (Entries.size() >= Capacity) is_new = false;
+            else is_new = Entries.try_emplace(name).second;
+            lock.unlock();
+            if (is_new && Subscribe) Subscribe(ChannelPrefix + name);
+        }
+
+        auto text = Connection->get(name);
+
+        // The value is kept only if its key is tracked and has not been modified since the read was sent.
+        std::unique_lock lock(EntriesMutex);
+        finder = Entries.find(name);
+        if (finder != Entries.end() && finder->second.Tracked && finder->second.Generation == generation)
+        {
+            finder->second.Text = text;
+            finder->second.Valid = true;
+        }
+        return text;
+    }
+
+    /// Drop the cached value of a key.
+    void RemoteValueCache::Invalidate(const std::string& name)
+    {
+        std::unique_lock lock(EntriesMutex);
+        auto finder = Entries.find(name);
+        if (finder == Entries.end()) return;
+        if (finder->second.Valid) InvalidationCount.fetch_add(1, std::memory_order_relaxed);
+        finder->second.Valid = false;
+        finder->second.Text.reset();
+        ++finder->second.Generation;
+    }
+
+    /// Drop all cached values and forget all subscriptions.
+    void RemoteValueCache::Reset()
+    {
+        std::unique_lock lock(EntriesMutex);
+        for (const auto& [name, entry] : Entries)
+        {
+            if (entry.Valid) InvalidationCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        // Generations restart from 0, so reads sent before the reset can not store their values.
+        Entries.clear();
+    }
+
+    /// Check whether the channel is a keyspace channel of this cache or not.
+    bool RemoteValueCache::IsKeyspaceChannel(std::string_view channel) const noexcept
+    {
+        return channel.size() > ChannelPrefix.size() && channel.compare(0, ChannelPrefix.size(), ChannelPrefix) == 0;
+    }
+
+    /// Drop the cached value of the key of a keyspace notification.
+    bool RemoteValueCache::HandleNotification(std::string_view channel)
+    {
+        if (!IsKeyspaceChannel(channel)) return false;
+        std::string name(channel.substr(ChannelPrefix.size()));
+        std::shared_lock lock(EntriesMutex);
+        if (Entries.count(name) == 0) return false;
+        lock.unlock();
+        Invalidate(name);
+        return true;
+    }
+
+    /// Start serving the key of a keyspace channel from memory.
+    void RemoteValueCache::HandleSubscribed(std::string_view channel)
+    {
+        if (!IsKeyspaceChannel(channel)) return;
+        std::unique_lock lock(EntriesMutex);
+        auto finder = Entries.find(std::string(channel.substr(ChannelPrefix.size())));
+        if (finder == Entries.end()) return;
+        // Modifications before the confirmation were not notified, so reads in flight are discarded.
+        finder->second.Tracked = true;
+        finder->second.Valid = false;
+        finder->second.Text.reset();
+        ++finder->second.Generation;
+    }
+
+    /// Check whether the server publishes keyspace notifications of generic, string and expiration events.
+    bool RemoteValueCache::CheckNotifications(sw::redis::Redis& connection)
+    {
+        std::vector<std::string> reply;
+        try
+        {
+            reply = connection.command<std::vector<std::string>>("CONFIG", "GET", "notify-keyspace-events");
+        }
+        catch (sw::redis::Error&)
+        {
+            return false;
+        }
+        if (reply.size() < 2) return false;
+        const auto& flags = reply[1];
+        auto has_flag = [&flags](char flag){
+            return flags.find(flag) != std::string::npos;
+        };
+        return has_flag('K') && (has_flag('A') || (has_flag('g') && has_flag('$') && has_flag('x')));
+    }
+
+    /// Get the ratio of reads served from memory.
+    double RemoteValueCache::GetHitRatio() const noexcept
+    {
+        auto hits = GetHitCount();
+        auto total = hits + GetMissCount();
+        if (total == 0) return 0;
+        return static_cast<double>(hits) / static_cast<double>(total);
+    }
+}
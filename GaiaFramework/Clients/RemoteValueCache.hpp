@@ -0,0 +1,118 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <memory>
+#include <functional>
+#include <unordered_map>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <sw/redis++/redis++.h>
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Read cache of remote values, invalidated by keyspace notifications.
+     * @details
+     *  Every cached key is tracked by a subscription to its keyspace channel "__keyspace@<db>__:<key>",
+     *  and its cached value is dropped when any client modifies, deletes or expires the key.
+     *  A key is only served from memory after its subscription has been confirmed by the server,
+     *  so no modification can be missed between the read and the subscription.
+     *  The server must publish keyspace notifications of generic, string and expiration events,
+     *  for example "notify-keyspace-events Kg$x", see CheckNotifications().
+     */
+    class RemoteValueCache
+    {
+    public:
+        /// Requests a subscription to a channel, it is invoked while no lock of the cache is held.
+        using SubscribeFunction = std::function<void(const std::string&)>;
+
+    private:
+        /// Connection to the Redis server.
+        std::shared_ptr<sw::redis::Redis> Connection;
+        /// Prefix of keyspace channels, "__keyspace@<db>__:".
+        const std::string ChannelPrefix;
+        /// Maximum count of cached keys, other keys are read from the server every time.
+        const std::size_t Capacity;
+        /// Requests subscriptions to keyspace channels.
+        SubscribeFunction Subscribe;
+
+        /// Cached state of a key.
+        struct Entry
+        {
+            /// The value, std::nullopt if the key does not exist.
+            std::optional<std::string> Text;
+            /// Whether the value is cached or not.
+            bool Valid {false};
+            /// Whether the subscription to the keyspace channel has been confirmed or not.
+            bool Tracked {false};
+            /// Increased by every invalidation, values read before an invalidation will not be cached.
+            std::uint64_t Generation {0};
+        };
+
+        /// Mutex for entries.
+        std::shared_mutex EntriesMutex;
+        /// Entries of keys, created when they are first read.
+        std::unordered_map<std::string, Entry> Entries;
+
+        std::atomic<std::uint64_t> HitCount {0};
+        std::atomic<std::uint64_t> MissCount {0};
+        std::atomic<std::uint64_t> InvalidationCount {0};
+
+    public:
+        /**
+         * @brief Bind the connection and the function to subscribe keyspace channels.
+         * @param connection Connection to read values.
+         * @param subscribe Requests a subscription to a keyspace channel, whose messages and subscription
+         *                  confirmations should be passed to HandleNotification() and HandleSubscribed().
+         * @param capacity Maximum count of cached keys.
+         * @param database Index of the database of the connection.
+         */
+        RemoteValueCache(std::shared_ptr<sw::redis::Redis> connection, SubscribeFunction subscribe,
+                         std::size_t capacity = 4096, unsigned int database = 0);
+
+        /**
+         * @brief Get the text of a remote value, from memory if it is cached.
+         * @return The text, or std::nullopt if the value does not exist.
+         */
+        std::optional<std::string> Get(const std::string& name);
+
+        /// Drop the cached value of a key, used when this process writes it.
+        void Invalidate(const std::string& name);
+        /// Drop all cached values and forget all subscriptions, used when the subscriber has reconnected.
+        void Reset();
+
+        /// Check whether the channel is a keyspace channel of this cache or not.
+        [[nodiscard]] bool IsKeyspaceChannel(std::string_view channel) const noexcept;
+        /// Drop the cached value of the key of a keyspace notification, returns false if the key is not tracked.
+        bool HandleNotification(std::string_view channel);
+        /// Start serving the key of a keyspace channel from memory, when its subscription is confirmed.
+        void HandleSubscribed(std::string_view channel);
+
+        /**
+         * @brief Check whether the server publishes keyspace notifications of generic, string and expiration events.
+         * @retval false Notifications are not enabled, or the configuration can not be read.
+         */
+        static bool CheckNotifications(sw::redis::Redis& connection);
+
+        /// Get the count of reads served from memory.
+        [[nodiscard]] inline std::uint64_t GetHitCount() const noexcept
+        {
+            return HitCount.load(std::memory_order_relaxed);
+        }
+        /// Get the count of reads sent to the server.
+        [[nodiscard]] inline std::uint64_t GetMissCount() const noexcept
+        {
+            return MissCount.load(std::memory_order_relaxed);
+        }
+        /// Get the count of cached values dropped by notifications or local writes.
+        [[nodiscard]] inline std::uint64_t GetInvalidationCount() const noexcept
+        {
+            return InvalidationCount.load(std::memory_order_relaxed);
+        }
+        /// Get the ratio of reads served from memory, 0 if nothing has been read.
+        [[nodiscard]] double GetHitRatio() const noexcept;
+    };
+}
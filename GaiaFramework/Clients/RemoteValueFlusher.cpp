@@ -0,0 +1,202 @@
+#include "RemoteValueFlusher.hpp"
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace Gaia::Framework::Clients
+{
+    /// Bind the flusher, the name and the options.
+    RemoteValueFlusher::Slot::Slot(RemoteValueFlusher& owner, std::string name, const Options& options) :
+        Owner(owner), Name(std::move(name)), Settings(options)
+    {}
+
+    /// Buffer the latest value.
+    void RemoteValueFlusher::Slot::Update(std::string text, std::optional<double> number)
+    {
+        Owner.SetCount.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock lock(ValueMutex);
+        bool was_dirty = Dirty;
+        Text = std::move(text);
+        Number = number;
+        Dirty = true;
+
+        // The flusher is woken up to schedule a newly dirty slot, further values wait for its interval.
+        bool needs_flush = !was_dirty;
+        if (!Urgent && Settings.Threshold > 0 && Number.has_value() &&
+            (!WrittenNumber.has_value() || std::abs(*Number - *WrittenNumber) > Settings.Threshold))
+        {
+            Urgent = true;
+            needs_flush = true;
+        }
+        lock.unlock();
+        if (needs_flush) Owner.RequestFlush();
+    }
+
+    /// Write the latest value in the next flush regardless of the interval.
+    void RemoteValueFlusher::Slot::Flush()
+    {
+        std::unique_lock lock(ValueMutex);
+        if (!Dirty) return;
+        Urgent = true;
+        lock.unlock();
+        Owner.RequestFlush();
+    }
+
+    /// Bind the connection.
+    RemoteValueFlusher::RemoteValueFlusher(std::shared_ptr<sw::redis::Redis> connection) :
+        Connection(std::move(connection)),
+        Flusher([this](const std::atomic_bool& life_flag){
+            this->FlushValues(life_flag);
+        })
+    {}
+
+    /// Stop the flusher, and write the buffered values.
+    RemoteValueFlusher::~RemoteValueFlusher()
+    {
+        Stop();
+    }
+
+    /// Create the slot of a remote value.
+    std::shared_ptr<RemoteValueFlusher::Slot> RemoteValueFlusher::CreateSlot(
+            const std::string& name, const Options& options)
+    {
+        auto slot = std::make_shared<Slot>(*this, name, options);
+        std::unique_lock lock(SlotsMutex);
+        Slots.push_back(slot);
+        return slot;
+    }
+
+    /// Wake up the flusher to write due values.
+    void RemoteValueFlusher::RequestFlush()
+    {
+        std::unique_lock lock(SlotsMutex);
+        FlushRequested = true;
+        lock.unlock();
+        FlushCondition.notify_one();
+    }
+
+    /// Write the values of due slots in one pipeline.
+    std::chrono::steady_clock::time_point RemoteValueFlusher::FlushSlots(bool force)
+    {
+        auto now = std::chrono::steady_clock::now();
+        auto next_time = std::chrono::steady_clock::time_point::max();
+
+        std::vector<std::shared_ptr<Slot>> slots;
+        std::unique_lock slots_lock(SlotsMutex);
+        FlushRequested = false;
+        // Slots released by their handles are dropped once their last values are written.
+        Slots.erase(std::remove_if(Slots.begin(), Slots.end(), [](const std::shared_ptr<Slot>& slot){
+            if (slot.use_count() > 1) return false;
+            std::unique_lock lock(slot->ValueMutex);
+            return !slot->Dirty;
+        }), Slots.end());
+        slots = Slots;
+        slots_lock.unlock();
+
+        // Texts are copied, so values can be restored if the pipeline fails.
+        std::vector<std::tuple<Slot*, std::string, std::optional<double>>> writes;
+        for (const auto& slot : slots)
+        {
+            std::unique_lock lock(slot->ValueMutex);
+            if (!slot->Dirty) continue;
+            auto due_time = slot->WriteTime + slot->Settings.Interval;
+            if (!force && !slot->Urgent && due_time > now)
+            {
+                next_time = std::min(next_time, due_time);
+                continue;
+            }
+            writes.emplace_back(slot.get(), slot->Text, slot->Number);
+            slot->Dirty = false;
+            slot->Urgent = false;
+            slot->WriteTime = now;
+        }
+        if (writes.empty()) return next_time;
+
+        try
+        {
+            if (!Pipeline)
+            {
+                Pipeline = std::make_unique<sw::redis::Pipeline>(Connection->pipeline());
+            }
+            for (const auto& [slot, text, number] : writes)
+            {
+                if (slot->Settings.TimeToLive.count() > 0)
+                    Pipeline->set(slot->Name, text, slot->Settings.TimeToLive);
+                else
+                    Pipeline->set(slot->Name, text);
+            }
+            Pipeline->exec();
+        }
+        catch (sw::redis::Error&)
+        {
+            // The pipeline connection may be broken, it will be recreated for the next flush.
+            Pipeline.reset();
+            FlushCount.fetch_add(1, std::memory_order_relaxed);
+            FailureCount.fetch_add(1, std::memory_order_relaxed);
+            for (const auto& [slot, text, number] : writes)
+            {
+                std::unique_lock lock(slot->ValueMutex);
+                // Newer values are kept, they will be written in place of the failed ones.
+                if (slot->Dirty) continue;
+                slot->Text = text;
+                slot->Number = number;
+                slot->Dirty = true;
+                next_time = std::min(next_time, slot->WriteTime + slot->Settings.Interval);
+            }
+            return next_time;
+        }
+
+        FlushCount.fetch_add(1, std::memory_order_relaxed);
+        WriteCount.fetch_add(writes.size(), std::memory_order_relaxed);
+        for (const auto& [slot, text, number] : writes)
+        {
+            std::unique_lock lock(slot->ValueMutex);
+            slot->WrittenNumber = number;
+            if (slot->Dirty) next_time = std::min(next_time, slot->WriteTime + slot->Settings.Interval);
+        }
+        return next_time;
+    }
+
+    /// Flush values until the life flag is false.
+    void RemoteValueFlusher::FlushValues(const std::atomic_bool& life_flag)
+    {
+        while (life_flag.load())
+        {
+            auto next_time = FlushSlots(false);
+            std::unique_lock lock(SlotsMutex);
+            if (FlushRequested) continue;
+            // Wake up regularly to observe the life flag.
+            FlushCondition.wait_until(lock, std::min(
+                    next_time, std::chrono::steady_clock::now() + std::chrono::milliseconds(100)));
+        }
+    }
+
+    /// Start writing values on the background thread.
+    void RemoteValueFlusher::Start()
+    {
+        if (FlusherRunning.exchange(true)) return;
+        Flusher.Start();
+    }
+
+    /// Stop the background thread, and write the buffered values.
+    void RemoteValueFlusher::Stop()
+    {
+        if (FlusherRunning.exchange(false))
+        {
+            FlushCondition.notify_all();
+            Flusher.Stop();
+        }
+        FlushSlots(true);
+    }
+
+    /// Get the statistics of the flusher.
+    RemoteValueFlusher::FlushStatistics RemoteValueFlusher::GetStatistics() const noexcept
+    {
+        FlushStatistics statistics;
+        statistics.SetCount = SetCount.load(std::memory_order_relaxed);
+        statistics.WriteCount = WriteCount.load(std::memory_order_relaxed);
+        statistics.FlushCount = FlushCount.load(std::memory_order_relaxed);
+        statistics.FailureCount = FailureCount.load(std::memory_order_relaxed);
+        return statistics;
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <memory>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <sw/redis++/redis++.h>
+#include <GaiaBackground/GaiaBackground.hpp>
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Background writer of remote values which coalesces frequent updates.
+     * @details
+     *  Values are buffered in slots, and only the latest value of a slot is written,
+     *  at most once per interval of the slot, or at once when it changes beyond the threshold of the slot.
+     *  All due slots are written together in one pipeline on one background thread.
+     *  Slots are used through Clients::RemoteValue handles.
+     */
+    class RemoteValueFlusher
+    {
+    public:
+        /// Options of a remote value.
+        struct Options
+        {
+            /// Minimum interval between two writes of the value.
+            std::chrono::milliseconds Interval {100};
+            /**
+             * @brief Numeric values which differ from the last written one by more than this are written at once.
+             * @details Ignored if it is 0 or the value is not arithmetic.
+             */
+            double Threshold {0};
+            /// The written value expires after this time, it does not expire if it is 0.
+            std::chrono::milliseconds TimeToLive {0};
+        };
+
+        /// Statistics of the flusher.
+        struct FlushStatistics
+        {
+            /// Count of values set by handles.
+            std::uint64_t SetCount {0};
+            /// Count of values written to the server.
+            std::uint64_t WriteCount {0};
+            /// Count of pipelines sent to the server.
+            std::uint64_t FlushCount {0};
+            /// Count of pipelines which failed, their values are written in the next flush.
+            std::uint64_t FailureCount {0};
+        };
+
+        /// Buffer of a remote value, shared by its handle and the flusher.
+        class Slot
+        {
+            friend class RemoteValueFlusher;
+
+        private:
+            RemoteValueFlusher& Owner;
+            const std::string Name;
+            const Options Settings;
+
+            /// Mutex for the buffered value.
+            std::mutex ValueMutex;
+            /// Text of the latest value.
+            std::string Text;
+            /// Numeric form of the latest value, used by the threshold.
+            std::optional<double> Number;
+            /// Numeric form of the last written value.
+            std::optional<double> WrittenNumber;
+            /// Whether the latest value has not been written or not.
+            bool Dirty {false};
+            /// Whether the latest value should be written regardless of the interval or not.
+            bool Urgent {false};
+            /// Time of the last write, values are not written again before the interval passes.
+            std::chrono::steady_clock::time_point WriteTime {};
+
+        public:
+            Slot(RemoteValueFlusher& owner, std::string name, const Options& options);
+
+            /// Buffer the latest value, the number is std::nullopt if the value is not arithmetic.
+            void Update(std::string text, std::optional<double> number);
+            /// Write the latest value in the next flush regardless of the interval.
+            void Flush();
+
+            /// Get the name of the remote value.
+            [[nodiscard]] inline const std::string& GetName() const noexcept
+            {
+                return Name;
+            }
+        };
+
+    private:
+        /// Connection to the Redis server.
+        std::shared_ptr<sw::redis::Redis> Connection;
+        /// Pipeline to write values, recreated after failures.
+        std::unique_ptr<sw::redis::Pipeline> Pipeline;
+
+        /// Mutex for slots.
+        std::mutex SlotsMutex;
+        /// Slots of all handles, slots only owned by the flusher are removed once they are written.
+        std::vector<std::shared_ptr<Slot>> Slots;
+        /// Notified when a value should be written before the flusher wakes up by itself.
+        std::condition_variable FlushCondition;
+        /// Whether a slot has requested an early flush or not.
+        bool FlushRequested {false};
+
+        std::atomic<std::uint64_t> SetCount {0};
+        std::atomic<std::uint64_t> WriteCount {0};
+        std::atomic<std::uint64_t> FlushCount {0};
+        std::atomic<std::uint64_t> FailureCount {0};
+
+        /// Wake up the flusher to write due values.
+        void RequestFlush();
+        /**
+         * @brief Write the values of due slots in one pipeline.
+         * @param force Write all dirty slots regardless of their intervals.
+         * @return The earliest time when a buffered value becomes due.
+         */
+        std::chrono::steady_clock::time_point FlushSlots(bool force);
+        /// Flush values until the life flag is false.
+        void FlushValues(const std::atomic_bool& life_flag);
+
+        /// Background worker which writes values.
+        Gaia::Background::BackgroundWorker Flusher;
+        /// Whether the background flusher is running or not.
+        std::atomic_bool FlusherRunning {false};
+
+    public:
+        /// Bind the connection.
+        explicit RemoteValueFlusher(std::shared_ptr<sw::redis::Redis> connection);
+        /// Stop the flusher, and write the buffered values.
+        ~RemoteValueFlusher();
+
+        /// Create the slot of a remote value.
+        std::shared_ptr<Slot> CreateSlot(const std::string& name, const Options& options);
+
+        /// Start writing values on the background thread.
+        void Start();
+        /// Stop the background thread, and write the buffered values.
+        void Stop();
+
+        /// Get the statistics of the flusher.
+        [[nodiscard]] FlushStatistics GetStatistics() const noexcept;
+    };
+}
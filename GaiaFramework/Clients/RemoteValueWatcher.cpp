@@ -0,0 +1,202 @@
+#include "RemoteValueWatcher.hpp"
+#include <chrono>
+#include <iterator>
+
+namespace Gaia::Framework::Clients
+{
+    /// Bind the connection and the function to subscribe keyspace channels.
+    RemoteValueWatcher::RemoteValueWatcher(std::shared_ptr<sw::redis::Redis> connection, SubscribeFunction subscribe,
+                                           unsigned int database) :
+        Connection(std::move(connection)),
+        ChannelPrefix("__keyspace@" + std::to_string(database) + "__:"),
+        Subscribe(std::move(subscribe)),
+        Notifier([this](const std::atomic_bool& life_flag){
+            this->DeliverChanges(life_flag);
+        })
+    {}
+
+    /// Stop the background notifier.
+    RemoteValueWatcher::~RemoteValueWatcher()
+    {
+        Stop();
+    }
+
+    /// Watch changes of a key.
+    void RemoteValueWatcher::Watch(const std::string& name, WatchHandler handler)
+    {
+        if (!handler) return;
+        std::unique_lock lock(WatchesMutex);
+        auto& handlers = Watches[name];
+        bool is_new = !handlers;
+        auto new_handlers = handlers ? std::make_shared<std::vector<WatchHandler>>(*handlers) :
+                                       std::make_shared<std::vector<WatchHandler>>();
+        new_handlers->push_back(std::move(handler));
+        handlers = std::move(new_handlers);
+        lock.unlock();
+
+        // New keys are read when their subscriptions are confirmed, new handlers of watched keys are read at once.
+        if (is_new)
+        {
+            if (Subscribe) Subscribe(ChannelPrefix + name);
+        }
+        else
+        {
+            MarkChanged(name);
+        }
+    }
+
+    /// Remove all handlers of a key.
+    void RemoteValueWatcher::Unwatch(const std::string& name)
+    {
+        std::unique_lock lock(WatchesMutex);
+        Watches.erase(name);
+    }
+
+    /// Read all watched keys again.
+    void RemoteValueWatcher::Refresh()
+    {
+        std::shared_lock lock(WatchesMutex);
+        for (const auto& [name, handlers] : Watches)
+        {
+            MarkChanged(name);
+        }
+    }
+
+    /// Request the subscriptions of all watched keys again.
+    void RemoteValueWatcher::Resubscribe()
+    {
+        std::vector<std::string> channels;
+        std::shared_lock lock(WatchesMutex);
+        channels.reserve(Watches.size());
+        for (const auto& [name, handlers] : Watches)
+        {
+            channels.push_back(ChannelPrefix + name);
+        }
+        lock.unlock();
+        // The subscribe function is invoked while no lock of the watcher is held.
+        for (const auto& channel : channels)
+        {
+            if (Subscribe) Subscribe(channel);
+        }
+    }
+
+    /// Mark a key as changed.
+    bool RemoteValueWatcher::MarkChanged(std::string name)
+    {
+        std::unique_lock lock(ChangesMutex);
+        if (!ChangedNames.insert(std::move(name)).second) return false;
+        lock.unlock();
+        ChangesCondition.notify_one();
+        return true;
+    }
+
+    /// Check whether the channel is a keyspace channel of this watcher or not.
+    bool RemoteValueWatcher::IsKeyspaceChannel(std::string_view channel) const noexcept
+    {
+        return channel.size() > ChannelPrefix.size() && channel.compare(0, ChannelPrefix.size(), ChannelPrefix) == 0;
+    }
+
+    /// Mark the key of a keyspace notification as changed.
+    bool RemoteValueWatcher::HandleNotification(std::string_view channel)
+    {
+        if (!IsKeyspaceChannel(channel)) return false;
+        std::string name(channel.substr(ChannelPrefix.size()));
+        std::shared_lock lock(WatchesMutex);
+        if (Watches.count(name) == 0) return false;
+        lock.unlock();
+        NotificationCount.fetch_add(1, std::memory_order_relaxed);
+        if (!MarkChanged(std::move(name))) CoalescedCount.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// Read the current value of the key of a keyspace channel.
+    void RemoteValueWatcher::HandleSubscribed(std::string_view channel)
+    {
+        if (!IsKeyspaceChannel(channel)) return;
+        std::string name(channel.substr(ChannelPrefix.size()));
+        std::shared_lock lock(WatchesMutex);
+        if (Watches.count(name) == 0) return;
+        lock.unlock();
+        MarkChanged(std::move(name));
+    }
+
+    /// Read changed keys and pass their values to handlers until the life flag is false.
+    void RemoteValueWatcher::DeliverChanges(const std::atomic_bool& life_flag)
+    {
+        while (life_flag.load())
+        {
+            std::unique_lock changes_lock(ChangesMutex);
+            if (ChangedNames.empty())
+            {
+                // Wake up regularly to observe the life flag.
+                ChangesCondition.wait_for(changes_lock, std::chrono::milliseconds(100));
+                continue;
+            }
+            // Changes marked from now on are read in the next round, so no change is lost.
+            std::vector<std::string> names(std::make_move_iterator(ChangedNames.begin()),
+                                           std::make_move_iterator(ChangedNames.end()));
+            ChangedNames.clear();
+            changes_lock.unlock();
+
+            std::vector<sw::redis::OptionalString> texts;
+            texts.reserve(names.size());
+            try
+            {
+                Connection->mget(names.begin(), names.end(), std::back_inserter(texts));
+            }
+            catch (sw::redis::Error&)
+            {
+                FailureCount.fetch_add(1, std::memory_order_relaxed);
+                changes_lock.lock();
+                ChangedNames.insert(std::make_move_iterator(names.begin()), std::make_move_iterator(names.end()));
+                // Retry after a while instead of flooding a broken connection.
+                ChangesCondition.wait_for(changes_lock, std::chrono::milliseconds(100));
+                continue;
+            }
+
+            for (std::size_t index = 0; index < names.size() && index < texts.size(); ++index)
+            {
+                std::shared_lock watches_lock(WatchesMutex);
+                auto finder = Watches.find(names[index]);
+                if (finder == Watches.end()) continue;
+                // The handlers are shared, so they can be invoked after they are unwatched.
+                auto handlers = finder->second;
+                watches_lock.unlock();
+
+                std::optional<std::string> text;
+                if (texts[index].has_value()) text = std::move(*texts[index]);
+                for (const auto& handler : *handlers)
+                {
+                    handler(text);
+                }
+                DeliveryCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /// Start invoking handlers on the background thread.
+    void RemoteValueWatcher::Start()
+    {
+        if (NotifierRunning.exchange(true)) return;
+        Notifier.Start();
+    }
+
+    /// Stop the background thread.
+    void RemoteValueWatcher::Stop()
+    {
+        if (!NotifierRunning.exchange(false)) return;
+        ChangesCondition.notify_all();
+        Notifier.Stop();
+    }
+
+    /// Get the statistics of the watcher.
+    RemoteValueWatcher::WatchStatistics RemoteValueWatcher::GetStatistics() const noexcept
+    {
+        WatchStatistics statistics;
+        statistics.NotificationCount = NotificationCount.load(std::memory_order_relaxed);
+        statistics.CoalescedCount = CoalescedCount.load(std::memory_order_relaxed);
+        statistics.DeliveryCount = DeliveryCount.load(std::memory_order_relaxed);
+        statistics.FailureCount = FailureCount.load(std::memory_order_relaxed);
+        return statistics;
+    }
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <memory>
+#include <functional>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <shared_mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+#include <sw/redis++/redis++.h>
+#include <GaiaBackground/GaiaBackground.hpp>
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Notifies handlers of changes of remote values, driven by keyspace notifications.
+     * @details
+     *  Every watched key is tracked by a subscription to its keyspace channel "__keyspace@<db>__:<key>".
+     *  A notification only marks its key as changed, and a background thread reads all changed keys
+     *  with one MGET and passes their latest values to the handlers.
+     *  Notifications which arrive while handlers are running are coalesced,
+     *  so slow handlers skip intermediate values instead of falling further behind.
+     *  The server must publish keyspace notifications, see RemoteValueCache::CheckNotifications().
+     */
+    class RemoteValueWatcher
+    {
+    public:
+        /// Requests a subscription to a channel, it is invoked while no lock of the watcher is held.
+        using SubscribeFunction = std::function<void(const std::string&)>;
+        /// Receives the text of the latest value, std::nullopt if the value has been deleted or has expired.
+        using WatchHandler = std::function<void(const std::optional<std::string>&)>;
+
+        /// Statistics of the watcher.
+        struct WatchStatistics
+        {
+            /// Count of received keyspace notifications of watched keys.
+            std::uint64_t NotificationCount {0};
+            /// Count of notifications merged into a pending change of the same key.
+            std::uint64_t CoalescedCount {0};
+            /// Count of values read and passed to handlers.
+            std::uint64_t DeliveryCount {0};
+            /// Count of reads which failed, their keys are read again later.
+            std::uint64_t FailureCount {0};
+        };
+
+    private:
+        /// Connection to the Redis server.
+        std::shared_ptr<sw::redis::Redis> Connection;
+        /// Prefix of keyspace channels, "__keyspace@<db>__:".
+        const std::string ChannelPrefix;
+        /// Requests subscriptions to keyspace channels.
+        SubscribeFunction Subscribe;
+
+        /// Mutex for handlers.
+        std::shared_mutex WatchesMutex;
+        /// Handlers of watched keys, replaced as a whole when they are modified.
+        std::unordered_map<std::string, std::shared_ptr<const std::vector<WatchHandler>>> Watches;
+
+        /// Mutex for changed keys.
+        std::mutex ChangesMutex;
+        /// Notified when keys are changed.
+        std::condition_variable ChangesCondition;
+        /// Keys changed since they were read last time.
+        std::unordered_set<std::string> ChangedNames;
+
+        std::atomic<std::uint64_t> NotificationCount {0};
+        std::atomic<std::uint64_t> CoalescedCount {0};
+        std::atomic<std::uint64_t> DeliveryCount {0};
+        std::atomic<std::uint64_t> FailureCount {0};
+
+        /// Mark a key as changed, returns false if it is already marked.
+        bool MarkChanged(std::string name);
+        /// Read changed keys and pass their values to handlers until the life flag is false.
+        void DeliverChanges(const std::atomic_bool& life_flag);
+
+        /// Background worker which reads changed keys and invokes handlers.
+        Gaia::Background::BackgroundWorker Notifier;
+        /// Whether the background notifier is running or not.
+        std::atomic_bool NotifierRunning {false};
+
+    public:
+        /**
+         * @brief Bind the connection and the function to subscribe keyspace channels.
+         * @param connection Connection to read values.
+         * @param subscribe Requests a subscription to a keyspace channel, whose messages and subscription
+         *                  confirmations should be passed to HandleNotification() and HandleSubscribed().
+         * @param database Index of the database of the connection.
+         */
+        RemoteValueWatcher(std::shared_ptr<sw::redis::Redis> connection, SubscribeFunction subscribe,
+                           unsigned int database = 0);
+        /// Stop the background notifier.
+        ~RemoteValueWatcher();
+
+        /**
+         * @brief Watch changes of a key.
+         * @details
+         *  The handler receives the current value once the subscription of the key is confirmed,
+         *  and the latest value after every change. Handlers are invoked on the background thread,
+         *  and a handler may receive the same value more than once.
+         */
+        void Watch(const std::string& name, WatchHandler handler);
+        /// Remove all handlers of a key, its keyspace channel stays subscribed.
+        void Unwatch(const std::string& name);
+        /// Read all watched keys again, used when notifications may have been lost.
+        void Refresh();
+        /// Request the subscriptions of all watched keys again, used after the subscriber is recreated.
+        void Resubscribe();
+
+        /// Check whether the channel is a keyspace channel of this watcher or not.
+        [[nodiscard]] bool IsKeyspaceChannel(std::string_view channel) const noexcept;
+        /// Mark the key of a keyspace notification as changed, returns false if the key is not watched.
+        bool HandleNotification(std::string_view channel);
+        /// Read the current value of the key of a keyspace channel, when its subscription is confirmed.
+        void HandleSubscribed(std::string_view channel);
+
+        /// Start invoking handlers on the background thread.
+        void Start();
+        /// Stop the background thread, pending changes are discarded.
+        void Stop();
+
+        /// Get the statistics of the watcher.
+        [[nodiscard]] WatchStatistics GetStatistics() const noexcept;
+    };
+}
@@ -0,0 +1,213 @@
+#include "RequestClient.hpp"
+
+#include <charconv>
+#include <random>
+
+namespace Gaia::Framework::Clients
+{
+    /// Generate a random token, so reply channels of replicas of the same service will not collide.
+    static std::string GenerateInstanceToken()
+    {
+        std::random_device device;
+        std::mt19937_64 generator(
+                (static_cast<std::uint64_t>(device()) << 32) ^ static_cast<std::uint64_t>(device()) ^
+                static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()));
+        char text[17];
+        auto [end, error] = std::to_chars(text, text + sizeof(text), generator(), 16);
+        return std::string(text, end);
+    }
+
+    /// Parse a decimal ID at the beginning of the text, returns the position after it or nullptr.
+    static const char* ParseId(std::string_view text, std::uint64_t& id)
+    {
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), id);
+        if (error != std::errc() || end == text.data()) return nullptr;
+        return end;
+    }
+
+    /// Bind the connection and generate a unique reply channel.
+    RequestClient::RequestClient(const std::string& caller_name, std::shared_ptr<sw::redis::Redis> connection) :
+        Connection(std::move(connection)), ReplyChannel(caller_name + "/reply/" + GenerateInstanceToken()),
+        Expirer([this](const std::atomic_bool& life_flag){
+            this->ExpireRequests(life_flag);
+        })
+    {
+        Expirer.Start();
+    }
+
+    /// Fail all pending requests and stop the background expirer.
+    RequestClient::~RequestClient()
+    {
+        DeadlineCondition.notify_all();
+        Expirer.Stop();
+
+        std::unordered_map<std::uint64_t, PendingRequest> pending_requests;
+        std::unique_lock lock(PendingMutex);
+        pending_requests.swap(PendingRequests);
+        lock.unlock();
+        for (auto& [id, request] : pending_requests)
+        {
+            if (request.Callback) request.Callback({ReplyStatus::Failed, "The request client is destroyed."});
+        }
+    }
+
+    /// Get the channel of requests to the given command of the given service.
+    std::string RequestClient::GetRequestChannel(const std::string& service_name, const std::string& command_name)
+    {
+        return service_name + "/request/" + command_name;
+    }
+
+    /// Encode a request message.
+    std::string RequestClient::EncodeRequest(std::uint64_t id, std::string_view reply_channel,
+                                             std::string_view content)
+    {
+        std::string message = std::to_string(id);
+        message.reserve(message.size() + reply_channel.size() + content.size() + 2);
+        message.push_back(' ');
+        message.append(reply_channel);
+        message.push_back('\n');
+        message.append(content);
+        return message;
+    }
+
+    /// Decode a request message.
+    std::optional<RequestClient::Request> RequestClient::DecodeRequest(std::string_view message)
+    {
+        Request request;
+        const auto* position = ParseId(message, request.Id);
+        if (!position || position == message.data() + message.size() || *position != ' ') return std::nullopt;
+        auto header_end = message.find('\n');
+        if (header_end == std::string_view::npos) return std::nullopt;
+        auto channel_begin = static_cast<std::size_t>(position - message.data()) + 1;
+        if (channel_begin >= header_end) return std::nullopt;
+        request.ReplyChannel = message.substr(channel_begin, header_end - channel_begin);
+        request.Content = message.substr(header_end + 1);
+        return request;
+    }
+
+    /// Encode a reply message.
+    std::string RequestClient::EncodeReply(std::uint64_t id, bool succeeded, std::string_view content)
+    {
+        std::string message = std::to_string(id);
+        message.reserve(message.size() + content.size() + 8);
+        message.append(succeeded ? " ok\n" : " error\n");
+        message.append(content);
+        return message;
+    }
+
+    /// Send a request and invoke the callback with its reply.
+    void RequestClient::SendRequest(const std::string& service_name, const std::string& command_name,
+                                    const std::string& content, std::chrono::milliseconds timeout,
+                                    ReplyCallback callback)
+    {
+        auto id = NextRequestId.fetch_add(1, std::memory_order_relaxed);
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+
+        // The request is registered before it is published, so a fast reply will always find it.
+        std::unique_lock lock(PendingMutex);
+        PendingRequests.emplace(id, PendingRequest{std::move(callback), deadline});
+        bool is_earliest = Deadlines.empty() || deadline < Deadlines.top().first;
+        Deadlines.emplace(deadline, id);
+        lock.unlock();
+        if (is_earliest) DeadlineCondition.notify_one();
+
+        try
+        {
+            Connection->publish(GetRequestChannel(service_name, command_name),
+                                EncodeRequest(id, ReplyChannel, content));
+        }
+        catch (sw::redis::Error& error)
+        {
+            lock.lock();
+            auto finder = PendingRequests.find(id);
+            if (finder == PendingRequests.end()) return;
+            auto failed_callback = std::move(finder->second.Callback);
+            PendingRequests.erase(finder);
+            lock.unlock();
+            if (failed_callback) failed_callback({ReplyStatus::Failed, error.what()});
+        }
+    }
+
+    /// Send a request and get a future of its reply.
+    std::future<RequestClient::Reply> RequestClient::SendRequest(
+            const std::string& service_name, const std::string& command_name,
+            const std::string& content, std::chrono::milliseconds timeout)
+    {
+        auto promise = std::make_shared<std::promise<Reply>>();
+        auto future = promise->get_future();
+        SendRequest(service_name, command_name, content, timeout,
+                    [promise](Reply reply){
+            promise->set_value(std::move(reply));
+        });
+        return future;
+    }
+
+    /// Complete the pending request of a reply from the reply channel.
+    void RequestClient::HandleReply(const std::string& message)
+    {
+        std::uint64_t id = 0;
+        const auto* position = ParseId(message, id);
+        if (!position) return;
+        auto header_end = message.find('\n');
+        if (header_end == std::string::npos) return;
+        bool succeeded = std::string_view(position, static_cast<std::size_t>(
+                message.data() + header_end - position)) == " ok";
+
+        std::unique_lock lock(PendingMutex);
+        auto finder = PendingRequests.find(id);
+        // The request may have timed out.
+        if (finder == PendingRequests.end()) return;
+        auto callback = std::move(finder->second.Callback);
+        PendingRequests.erase(finder);
+        lock.unlock();
+
+        if (!callback) return;
+        callback({succeeded ? ReplyStatus::Succeeded : ReplyStatus::Failed, message.substr(header_end + 1)});
+    }
+
+    /// Get the count of requests waiting for their replies.
+    std::size_t RequestClient::GetPendingCount()
+    {
+        std::unique_lock lock(PendingMutex);
+        return PendingRequests.size();
+    }
+
+    /// Fail requests whose deadlines have passed until the life flag is false.
+    void RequestClient::ExpireRequests(const std::atomic_bool& life_flag)
+    {
+        std::vector<ReplyCallback> expired_callbacks;
+        while (life_flag.load())
+        {
+            std::unique_lock lock(PendingMutex);
+            if (Deadlines.empty())
+            {
+                DeadlineCondition.wait_for(lock, std::chrono::milliseconds(100));
+                continue;
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (Deadlines.top().first > now)
+            {
+                DeadlineCondition.wait_until(lock, std::min(Deadlines.top().first,
+                                                            now + std::chrono::milliseconds(100)));
+                continue;
+            }
+            while (!Deadlines.empty() && Deadlines.top().first <= now)
+            {
+                auto finder = PendingRequests.find(Deadlines.top().second);
+                Deadlines.pop();
+                // Requests which have been replied are skipped.
+                if (finder == PendingRequests.end()) continue;
+                expired_callbacks.push_back(std::move(finder->second.Callback));
+                PendingRequests.erase(finder);
+            }
+            lock.unlock();
+
+            TimeoutCount.fetch_add(expired_callbacks.size(), std::memory_order_relaxed);
+            for (auto& callback : expired_callbacks)
+            {
+                if (callback) callback({ReplyStatus::TimedOut, {}});
+            }
+            expired_callbacks.clear();
+        }
+    }
+}
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <optional>
+#include <memory>
+#include <future>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <queue>
+#include <vector>
+#include <functional>
+#include <unordered_map>
+#include <condition_variable>
+#include <cstdint>
+#include <sw/redis++/redis++.h>
+#include <GaiaBackground/GaiaBackground.hpp>
+
+namespace Gaia::Framework::Clients
+{
+    /**
+     * @brief Client which sends requests to service commands and matches their replies.
+     * @details
+     *  A request is published on "<service>/request/<command>" as "<id> <reply channel>\n<content>",
+     *  and its reply is published on the reply channel of the caller as "<id> <status>\n<content>",
+     *  where the status is "ok" or "error".
+     *  Requests are identified by increasing correlation IDs, so any count of requests can be in flight.
+     *  Replies should be passed to HandleReply() by the subscriber of the reply channel.
+     */
+    class RequestClient
+    {
+    public:
+        /// Status of a reply.
+        enum class ReplyStatus
+        {
+            Succeeded = 0,  ///< The command returned its result.
+            Failed = 1,     ///< The command failed, or the request could not be sent.
+            TimedOut = 2    ///< No reply arrived in time.
+        };
+
+        /// Reply of a request.
+        struct Reply
+        {
+            ReplyStatus Status {ReplyStatus::TimedOut};
+            /// Result of the command if it succeeded, otherwise the error message.
+            std::string Content;
+
+            /// Check whether the command succeeded or not.
+            [[nodiscard]] inline bool IsSucceeded() const noexcept
+            {
+                return Status == ReplyStatus::Succeeded;
+            }
+        };
+
+        /// Callback of a request, receives its reply.
+        using ReplyCallback = std::function<void(Reply)>;
+
+        /// Decoded request.
+        struct Request
+        {
+            std::uint64_t Id {0};
+            std::string ReplyChannel;
+            std::string Content;
+        };
+
+    private:
+        /// Connection to the Redis server.
+        std::shared_ptr<sw::redis::Redis> Connection;
+        /// Channel on which replies to this client are published.
+        const std::string ReplyChannel;
+
+        /// Request waiting for its reply.
+        struct PendingRequest
+        {
+            ReplyCallback Callback;
+            std::chrono::steady_clock::time_point Deadline;
+        };
+        /// Deadline of a request, ordered by the earliest deadline first.
+        using Deadline = std::pair<std::chrono::steady_clock::time_point, std::uint64_t>;
+
+        /// Mutex for pending requests.
+        std::mutex PendingMutex;
+        /// Notified when a request with an earlier deadline is sent.
+        std::condition_variable DeadlineCondition;
+        /// Requests waiting for their replies.
+        std::unordered_map<std::uint64_t, PendingRequest> PendingRequests;
+        /// Deadlines of pending requests, entries of completed requests are skipped.
+        std::priority_queue<Deadline, std::vector<Deadline>, std::greater<>> Deadlines;
+        /// ID of the next request.
+        std::atomic<std::uint64_t> NextRequestId {1};
+        /// Count of requests which timed out.
+        std::atomic<std::uint64_t> TimeoutCount {0};
+
+        /// Fail requests whose deadlines have passed until the life flag is false.
+        void ExpireRequests(const std::atomic_bool& life_flag);
+
+        /// Background worker which fails timed out requests.
+        Gaia::Background::BackgroundWorker Expirer;
+
+    public:
+        /**
+         * @brief Bind the connection and generate a unique reply channel.
+         * @param caller_name Name of the caller, used as the prefix of the reply channel.
+         * @param connection Connection to the Redis server.
+         */
+        RequestClient(const std::string& caller_name, std::shared_ptr<sw::redis::Redis> connection);
+        /// Fail all pending requests and stop the background expirer.
+        ~RequestClient();
+
+        /// Get the channel on which replies to this client are published.
+        [[nodiscard]] inline const std::string& GetReplyChannel() const noexcept
+        {
+            return ReplyChannel;
+        }
+
+        /**
+         * @brief Send a request and invoke the callback with its reply.
+         * @param service_name Name of the target service.
+         * @param command_name Name of the command.
+         * @param content Content of the request.
+         * @param timeout The callback receives a reply of ReplyStatus::TimedOut if no reply arrives in this time.
+         * @param callback Invoked with the reply on the thread which calls HandleReply(),
+         *                 or on the expirer thread on timeout. In a service, replies are handled like other
+         *                 subscription messages: on the message thread, or on a thread of the message pool
+         *                 when "message-threads" is above 0.
+         */
+        void SendRequest(const std::string& service_name, const std::string& command_name,
+                         const std::string& content, std::chrono::milliseconds timeout, ReplyCallback callback);
+        /**
+         * @brief Send a request and get a future of its reply.
+         * @return Future of the reply, which tells whether the command succeeded, failed or timed out.
+         */
+        std::future<Reply> SendRequest(
+                const std::string& service_name, const std::string& command_name,
+                const std::string& content, std::chrono::milliseconds timeout);
+
+        /// Complete the pending request of a reply from the reply channel.
+        void HandleReply(const std::string& message);
+
+        /// Get the count of requests waiting for their replies.
+        [[nodiscard]] std::size_t GetPendingCount();
+        /// Get the count of requests which timed out.
+        [[nodiscard]] inline std::uint64_t GetTimeoutCount() const noexcept
+        {
+            return TimeoutCount.load(std::memory_order_relaxed);
+        }
+
+        /// Get the channel of requests to the given command of the given service.
+        static std::string GetRequestChannel(const std::string& service_name, const std::string& command_name);
+        /// Encode a request message.
+        static std::string EncodeRequest(std::uint64_t id, std::string_view reply_channel, std::string_view content);
+        /// Decode a request message, std::nullopt if the message is malformed.
+        static std::optional<Request> DecodeRequest(std::string_view message);
+        /// Encode a reply message.
+        static std::string EncodeReply(std::uint64_t id, bool succeeded, std::string_view content);
+    };
+}
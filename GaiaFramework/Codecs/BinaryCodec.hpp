@@ -0,0 +1,416 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Gaia::Framework::Codecs
+{
+    /**
+     * @brief Schema information of a type encoded by the binary codec.
+     * @details
+     *  Specialize it to declare the version of a type, and increase the version when its layout changes,
+     *  so receivers built with another layout will reject the content instead of misreading it.
+     */
+    template <typename ValueType>
+    struct BinarySchema
+    {
+        static constexpr std::uint8_t Version = 0;
+    };
+
+    /// Version of the binary format, written as the first byte of every encoded content.
+    constexpr std::uint8_t BinaryFormatVersion = 1;
+
+    namespace Detail
+    {
+        template <typename ValueType>
+        struct IsVector : std::false_type
+        {};
+        template <typename ElementType, typename AllocatorType>
+        struct IsVector<std::vector<ElementType, AllocatorType>> : std::true_type
+        {};
+
+        template <typename ValueType>
+        struct IsOptional : std::false_type
+        {};
+        template <typename ElementType>
+        struct IsOptional<std::optional<ElementType>> : std::true_type
+        {};
+
+        /**
+         * @brief Values which are copied as raw bytes.
+         * @details
+         *  Only pointers themselves are rejected, pointers nested in trivially copyable structs or arrays
+         *  can not be detected and are copied as addresses.
+         */
+        template <typename ValueType>
+        constexpr bool IsRawValue = std::is_trivially_copyable_v<ValueType> && !std::is_pointer_v<ValueType> &&
+                                    !std::is_member_pointer_v<ValueType>;
+
+        /// Placeholder convertible to any field type, used to count fields of aggregates.
+        struct AnyField
+        {
+            template <typename FieldType>
+            operator FieldType() const;
+        };
+
+        template <typename ValueType, typename IndexSequence, typename = void>
+        struct IsBraceConstructible : std::false_type
+        {};
+        template <typename ValueType, std::size_t... Indices>
+        struct IsBraceConstructible<ValueType, std::index_sequence<Indices...>,
+                std::void_t<decltype(ValueType{(static_cast<void>(Indices), AnyField{})...})>> : std::true_type
+        {};
+
+        /// Maximum count of fields of aggregates which are encoded field by field.
+        constexpr std::size_t MaxFieldCount = 12;
+
+        /// Count the fields of an aggregate, by the most initializers it accepts.
+        template <typename ValueType, std::size_t Count = 0>
+        constexpr std::size_t CountFields()
+        {
+            if constexpr (Count < MaxFieldCount &&
+                          IsBraceConstructible<ValueType, std::make_index_sequence<Count + 1>>::value)
+            {
+                return CountFields<ValueType, Count + 1>();
+            }
+            else
+            {
+                return Count;
+            }
+        }
+
+        /// Invoke the visitor on every field of an aggregate in their declaration order.
+        template <typename ValueType, typename VisitorType>
+        void ForEachField(ValueType& value, VisitorType&& visitor)
+        {
+            constexpr auto count = CountFields<std::remove_const_t<ValueType>>();
+            static_assert(count > 0, "The aggregate has no field or too many fields to encode.");
+            if constexpr (count == 1)
+            {
+                auto& [f1] = value;
+                visitor(f1);
+            }
+            else if constexpr (count == 2)
+            {
+                auto& [f1, f2] = value;
+                visitor(f1); visitor(f2);
+            }
+            else if constexpr (count == 3)
+            {
+                auto& [f1, f2, f3] = value;
+                visitor(f1); visitor(f2); visitor(f3);
+            }
+            else if constexpr (count == 4)
+            {
+                auto& [f1, f2, f3, f4] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4);
+            }
+            else if constexpr (count == 5)
+            {
+                auto& [f1, f2, f3, f4, f5] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4); visitor(f5);
+            }
+            else if constexpr (count == 6)
+            {
+                auto& [f1, f2, f3, f4, f5, f6] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4); visitor(f5); visitor(f6);
+            }
+            else if constexpr (count == 7)
+            {
+                auto& [f1, f2, f3, f4, f5, f6, f7] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4); visitor(f5); visitor(f6); visitor(f7);
+            }
+            else if constexpr (count == 8)
+            {
+                auto& [f1, f2, f3, f4, f5, f6, f7, f8] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4); visitor(f5); visitor(f6); visitor(f7);
+                visitor(f8);
+            }
+            else if constexpr (count == 9)
+            {
+                auto& [f1, f2, f3, f4, f5, f6, f7, f8, f9] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4); visitor(f5); visitor(f6); visitor(f7);
+                visitor(f8); visitor(f9);
+            }
+            else if constexpr (count == 10)
+            {
+                auto& [f1, f2, f3, f4, f5, f6, f7, f8, f9, f10] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4); visitor(f5); visitor(f6); visitor(f7);
+                visitor(f8); visitor(f9); visitor(f10);
+            }
+            else if constexpr (count == 11)
+            {
+                auto& [f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4); visitor(f5); visitor(f6); visitor(f7);
+                visitor(f8); visitor(f9); visitor(f10); visitor(f11);
+            }
+            else
+            {
+                auto& [f1, f2, f3, f4, f5, f6, f7, f8, f9, f10, f11, f12] = value;
+                visitor(f1); visitor(f2); visitor(f3); visitor(f4); visitor(f5); visitor(f6); visitor(f7);
+                visitor(f8); visitor(f9); visitor(f10); visitor(f11); visitor(f12);
+            }
+        }
+    }
+
+    /**
+     * @brief Check whether a type can be encoded by the binary codec.
+     * @details
+     *  Supported types are trivially copyable types other than pointers, std::string, std::vector and std::optional
+     *  of supported types, and aggregates of up to 12 supported fields without C array members.
+     *  Fields of aggregates are checked when they are encoded.
+     * @warning
+     *  Trivially copyable types are copied as raw bytes as a whole, so pointer members of trivially copyable
+     *  structs are not rejected, and they are meaningless to the receiver. Such structs must not be encoded.
+     */
+    template <typename ValueType>
+    constexpr bool IsBinaryEncodable = Detail::IsRawValue<ValueType> || std::is_same_v<ValueType, std::string> ||
+                                       Detail::IsVector<ValueType>::value || Detail::IsOptional<ValueType>::value ||
+                                       (std::is_aggregate_v<ValueType> && !std::is_array_v<ValueType>);
+
+    /**
+     * @brief Appends values in the compact binary format.
+     * @details
+     *  Trivially copyable values are copied as their raw bytes in the byte order of the host,
+     *  lengths of strings and vectors are written as variable-length integers,
+     *  and aggregates are written field by field.
+     */
+    class BinaryWriter
+    {
+    private:
+        std::string& Buffer;
+
+    public:
+        explicit BinaryWriter(std::string& buffer) noexcept : Buffer(buffer)
+        {}
+
+        /// Append raw bytes.
+        void WriteBytes(const void* data, std::size_t size)
+        {
+            Buffer.append(static_cast<const char*>(data), size);
+        }
+
+        /// Append an unsigned integer in 7 bits per byte, with the highest bit marking following bytes.
+        void WriteLength(std::uint64_t length)
+        {
+            while (length >= 0x80)
+            {
+                Buffer.push_back(static_cast<char>((length & 0x7F) | 0x80));
+                length >>= 7;
+            }
+            Buffer.push_back(static_cast<char>(length));
+        }
+
+        /// Append a value.
+        template <typename ValueType>
+        void Write(const ValueType& value)
+        {
+            if constexpr (Detail::IsRawValue<ValueType>)
+            {
+                WriteBytes(&value, sizeof(ValueType));
+            }
+            else if constexpr (std::is_same_v<ValueType, std::string>)
+            {
+                WriteLength(value.size());
+                WriteBytes(value.data(), value.size());
+            }
+            else if constexpr (Detail::IsVector<ValueType>::value)
+            {
+                WriteLength(value.size());
+                if constexpr (Detail::IsRawValue<typename ValueType::value_type>)
+                {
+                    WriteBytes(value.data(), value.size() * sizeof(typename ValueType::value_type));
+                }
+                else
+                {
+                    for (const auto& element : value)
+                    {
+                        Write(element);
+                    }
+                }
+            }
+            else if constexpr (Detail::IsOptional<ValueType>::value)
+            {
+                Buffer.push_back(value.has_value() ? 1 : 0);
+                if (value.has_value()) Write(*value);
+            }
+            else
+            {
+                static_assert(IsBinaryEncodable<ValueType>, "The type is not supported by the binary codec.");
+                Detail::ForEachField(value, [this](const auto& field){
+                    this->Write(field);
+                });
+            }
+        }
+    };
+
+    /**
+     * @brief Reads values in the compact binary format from a view of the content.
+     * @details Reading stops at the first malformed or truncated value, and the reader is marked as failed.
+     */
+    class BinaryReader
+    {
+    private:
+        std::string_view Data;
+        bool Failed {false};
+
+    public:
+        explicit BinaryReader(std::string_view data) noexcept : Data(data)
+        {}
+
+        /// Check whether a read has failed or not.
+        [[nodiscard]] bool HasFailed() const noexcept
+        {
+            return Failed;
+        }
+        /// Get the count of bytes which have not been read.
+        [[nodiscard]] std::size_t GetRemainingSize() const noexcept
+        {
+            return Data.size();
+        }
+
+        /// Read raw bytes.
+        bool ReadBytes(void* data, std::size_t size)
+        {
+            if (Failed || Data.size() < size)
+            {
+                Failed = true;
+                return false;
+            }
+            if (size > 0) std::memcpy(data, Data.data(), size);
+            Data.remove_prefix(size);
+            return true;
+        }
+
+        /// Read an unsigned integer written by BinaryWriter::WriteLength().
+        bool ReadLength(std::uint64_t& length)
+        {
+            length = 0;
+            for (unsigned int shift = 0; shift < 64 && !Failed && !Data.empty(); shift += 7)
+            {
+                auto byte = static_cast<std::uint8_t>(Data.front());
+                Data.remove_prefix(1);
+                length |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+                if ((byte & 0x80) == 0) return true;
+            }
+            Failed = true;
+            return false;
+        }
+
+        /// Read a value.
+        template <typename ValueType>
+        bool Read(ValueType& value)
+        {
+            if (Failed) return false;
+            if constexpr (Detail::IsRawValue<ValueType>)
+            {
+                return ReadBytes(&value, sizeof(ValueType));
+            }
+            else if constexpr (std::is_same_v<ValueType, std::string>)
+            {
+                std::uint64_t length = 0;
+                if (!ReadLength(length)) return false;
+                if (Data.size() < length)
+                {
+                    Failed = true;
+                    return false;
+                }
+                value.assign(Data.data(), static_cast<std::size_t>(length));
+                Data.remove_prefix(static_cast<std::size_t>(length));
+                return true;
+            }
+            else if constexpr (Detail::IsVector<ValueType>::value)
+            {
+                using ElementType = typename ValueType::value_type;
+                std::uint64_t count = 0;
+                if (!ReadLength(count)) return false;
+                // Every element takes at least one byte, so a corrupted count can not cause a huge allocation.
+                if (count > Data.size())
+                {
+                    Failed = true;
+                    return false;
+                }
+                value.resize(static_cast<std::size_t>(count));
+                if constexpr (Detail::IsRawValue<ElementType>)
+                {
+                    return ReadBytes(value.data(), value.size() * sizeof(ElementType));
+                }
+                else
+                {
+                    for (auto& element : value)
+                    {
+                        if (!Read(element)) return false;
+                    }
+                    return true;
+                }
+            }
+            else if constexpr (Detail::IsOptional<ValueType>::value)
+            {
+                std::uint8_t has_value = 0;
+                if (!ReadBytes(&has_value, 1)) return false;
+                if (has_value == 0)
+                {
+                    value.reset();
+                    return true;
+                }
+                return Read(value.emplace());
+            }
+            else
+            {
+                static_assert(IsBinaryEncodable<ValueType>, "The type is not supported by the binary codec.");
+                Detail::ForEachField(value, [this](auto& field){
+                    this->Read(field);
+                });
+                return !Failed;
+            }
+        }
+    };
+
+    /**
+     * @brief Encode a value into the versioned binary format.
+     * @return Content made of the format version, the schema version of the type, and the value.
+     */
+    template <typename ValueType>
+    std::string EncodeBinary(const ValueType& value)
+    {
+        std::string content;
+        content.reserve(2 + (Detail::IsRawValue<ValueType> ? sizeof(ValueType) : 0));
+        content.push_back(static_cast<char>(BinaryFormatVersion));
+        content.push_back(static_cast<char>(BinarySchema<ValueType>::Version));
+        BinaryWriter(content).Write(value);
+        return content;
+    }
+
+    /**
+     * @brief Decode a value from the versioned binary format.
+     * @retval true The value has been decoded.
+     * @retval false The versions do not match, or the content is malformed.
+     */
+    template <typename ValueType>
+    bool DecodeBinary(std::string_view content, ValueType& value)
+    {
+        if (content.size() < 2 ||
+            static_cast<std::uint8_t>(content[0]) != BinaryFormatVersion ||
+            static_cast<std::uint8_t>(content[1]) != BinarySchema<ValueType>::Version)
+        {
+            return false;
+        }
+        BinaryReader reader(content.substr(2));
+        return reader.Read(value) && reader.GetRemainingSize() == 0;
+    }
+
+    /// Decode a value from the versioned binary format, std::nullopt if it can not be decoded.
+    template <typename ValueType>
+    std::optional<ValueType> DecodeBinary(std::string_view content)
+    {
+        ValueType value {};
+        if (!DecodeBinary(content, value)) return std::nullopt;
+        return value;
+    }
+}
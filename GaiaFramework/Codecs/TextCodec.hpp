@@ -0,0 +1,198 @@
+#pragma once
+
+#include <charconv>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace Gaia::Framework::Codecs
+{
+    /**
+     * @brief Converts values of a type to and from text.
+     * @details
+     *  Specialize it for user types with two static functions:
+     *  "void Encode(std::string& buffer, const ValueType& value)" which appends the text of the value,
+     *  and "bool Decode(std::string_view text, ValueType& value)" which returns false if the text is invalid.
+     *  The primary template is left undefined, so unsupported types fail at compile time.
+     */
+    template <typename ValueType, typename = void>
+    struct TextCodec;
+
+    /// Numbers are written by std::to_chars, floating point numbers in the shortest text that round-trips exactly.
+    template <typename ValueType>
+    struct TextCodec<ValueType, std::enable_if_t<std::is_arithmetic_v<ValueType> &&
+                                                 !std::is_same_v<ValueType, bool> &&
+                                                 !std::is_same_v<ValueType, char>>>
+    {
+        static void Encode(std::string& buffer, ValueType value)
+        {
+            char text[64];
+            auto [end, error] = std::to_chars(text, text + sizeof(text), value);
+            buffer.append(text, end);
+        }
+
+        /// The whole text must be a number, a leading '+' is accepted.
+        static bool Decode(std::string_view text, ValueType& value) noexcept
+        {
+            if (text.size() > 1 && text.front() == '+' && text[1] != '-' && text[1] != '+') text.remove_prefix(1);
+            const auto* end = text.data() + text.size();
+            std::from_chars_result result {};
+            if constexpr (std::is_floating_point_v<ValueType>)
+            {
+                result = std::from_chars(text.data(), end, value, std::chars_format::general);
+            }
+            else
+            {
+                result = std::from_chars(text.data(), end, value);
+            }
+            return result.ec == std::errc() && result.ptr == end && !text.empty();
+        }
+    };
+
+    /// Booleans are written as "1" or "0", as std::to_string() did, and "true" or "false" are also accepted.
+    template <>
+    struct TextCodec<bool>
+    {
+        static void Encode(std::string& buffer, bool value)
+        {
+            buffer.push_back(value ? '1' : '0');
+        }
+
+        static bool Decode(std::string_view text, bool& value) noexcept
+        {
+            if (text == "1" || text == "true")
+            {
+                value = true;
+                return true;
+            }
+            if (text == "0" || text == "false")
+            {
+                value = false;
+                return true;
+            }
+            return false;
+        }
+    };
+
+    /// Characters are written as themselves, while signed and unsigned chars are numbers.
+    template <>
+    struct TextCodec<char>
+    {
+        static void Encode(std::string& buffer, char value)
+        {
+            buffer.push_back(value);
+        }
+
+        static bool Decode(std::string_view text, char& value) noexcept
+        {
+            if (text.size() != 1) return false;
+            value = text.front();
+            return true;
+        }
+    };
+
+    /// Enumerations are written as their underlying integers.
+    template <typename ValueType>
+    struct TextCodec<ValueType, std::enable_if_t<std::is_enum_v<ValueType>>>
+    {
+        using UnderlyingType = std::underlying_type_t<ValueType>;
+
+        static void Encode(std::string& buffer, ValueType value)
+        {
+            TextCodec<UnderlyingType>::Encode(buffer, static_cast<UnderlyingType>(value));
+        }
+
+        static bool Decode(std::string_view text, ValueType& value) noexcept
+        {
+            UnderlyingType number {};
+            if (!TextCodec<UnderlyingType>::Decode(text, number)) return false;
+            value = static_cast<ValueType>(number);
+            return true;
+        }
+    };
+
+    /// Strings are written as they are.
+    template <>
+    struct TextCodec<std::string>
+    {
+        static void Encode(std::string& buffer, const std::string& value)
+        {
+            buffer.append(value);
+        }
+
+        static bool Decode(std::string_view text, std::string& value)
+        {
+            value.assign(text);
+            return true;
+        }
+    };
+
+    /// String views and C strings can be encoded, but not decoded.
+    template <typename ValueType>
+    struct TextCodec<ValueType, std::enable_if_t<std::is_same_v<ValueType, std::string_view> ||
+                                                 std::is_same_v<ValueType, const char*> ||
+                                                 std::is_same_v<ValueType, char*>>>
+    {
+        static void Encode(std::string& buffer, std::string_view value)
+        {
+            buffer.append(value);
+        }
+    };
+
+    namespace Detail
+    {
+        template <typename ValueType, typename = void>
+        struct HasTextCodec : std::false_type
+        {};
+        template <typename ValueType>
+        struct HasTextCodec<ValueType, std::void_t<decltype(TextCodec<ValueType>::Encode(
+                std::declval<std::string&>(), std::declval<const ValueType&>()))>> : std::true_type
+        {};
+    }
+
+    /// Check whether values of a type can be converted to text or not.
+    template <typename ValueType>
+    constexpr bool IsTextEncodable = Detail::HasTextCodec<std::decay_t<ValueType>>::value;
+
+    /// Append the text of a value to the buffer.
+    template <typename ValueType>
+    void AppendText(std::string& buffer, const ValueType& value)
+    {
+        TextCodec<std::decay_t<ValueType>>::Encode(buffer, value);
+    }
+
+    /// Get the text of a value.
+    template <typename ValueType>
+    std::string EncodeText(const ValueType& value)
+    {
+        std::string text;
+        AppendText(text, value);
+        return text;
+    }
+
+    /**
+     * @brief Parse a value from the text.
+     * @retval true The value has been parsed.
+     * @retval false The text is invalid, the value is left unchanged.
+     */
+    template <typename ValueType>
+    bool DecodeText(std::string_view text, ValueType& value)
+    {
+        // Parse into a temporary, so an invalid text will not leave the value half assigned.
+        ValueType result {};
+        if (!TextCodec<ValueType>::Decode(text, result)) return false;
+        value = std::move(result);
+        return true;
+    }
+
+    /// Parse a value from the text, std::nullopt if the text is invalid.
+    template <typename ValueType>
+    std::optional<ValueType> DecodeText(std::string_view text)
+    {
+        ValueType value {};
+        if (!TextCodec<ValueType>::Decode(text, value)) return std::nullopt;
+        return value;
+    }
+}
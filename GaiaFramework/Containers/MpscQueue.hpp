@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <optional>
+#include <utility>
+
+namespace Gaia::Framework::Containers
+{
+    /**
+     * @brief Unbounded lock-free queue for multiple producers and a single consumer.
+     * @tparam ElementType Type of elements, must be default constructible.
+     * @details
+     *  Push(...) is wait-free and can be invoked from any thread,
+     *  while Pop() must only be invoked from one consumer thread.
+     *  Pop() may miss an element whose Push(...) is still in progress,
+     *  it will be visible in a later Pop().
+     */
+    template <typename ElementType>
+    class MpscQueue
+    {
+    private:
+        /// Node of the linked list.
+        struct Node
+        {
+            /// Next node, written by the producer which pushes it.
+            std::atomic<Node*> Next {nullptr};
+            /// Element stored in this node.
+            ElementType Element;
+        };
+
+        /// The latest pushed node, exchanged by producers.
+        std::atomic<Node*> Head;
+        /// The consumed node whose next node is the oldest element, only used by the consumer.
+        Node* Tail;
+
+    public:
+        /// Construct an empty queue.
+        MpscQueue() : Head(new Node), Tail(Head.load(std::memory_order_relaxed))
+        {}
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        /// Destruct the queue and the remaining elements.
+        ~MpscQueue()
+        {
+            while (Tail)
+            {
+                auto* next = Tail->Next.load(std::memory_order_relaxed);
+                delete Tail;
+                Tail = next;
+            }
+        }
+
+        /// Push an element into the queue, multi-threads safe to use.
+        void Push(ElementType element)
+        {
+            auto* node = new Node;
+            node->Element = std::move(element);
+            auto* previous = Head.exchange(node, std::memory_order_acq_rel);
+            previous->Next.store(node, std::memory_order_release);
+        }
+
+        /**
+         * @brief Pop the oldest element from the queue.
+         * @return The oldest element, or std::nullopt if the queue is empty.
+         * @attention Only one thread can invoke this function at the same time.
+         */
+        std::optional<ElementType> Pop()
+        {
+            auto* next = Tail->Next.load(std::memory_order_acquire);
+            if (!next) return std::nullopt;
+            std::optional<ElementType> element {std::move(next->Element)};
+            delete Tail;
+            Tail = next;
+            return element;
+        }
+
+        /**
+         * @brief Check whether the queue is empty or not.
+         * @attention Only the consumer thread will get a reliable result.
+         */
+        [[nodiscard]] bool IsEmpty() const noexcept
+        {
+            return Tail->Next.load(std::memory_order_acquire) == nullptr;
+        }
+    };
+}
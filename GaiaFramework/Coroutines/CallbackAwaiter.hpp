@@ -0,0 +1,55 @@
+#pragma once
+
+#include <coroutine>
+#include <functional>
+#include <optional>
+#include <utility>
+
+#include "Scheduler.hpp"
+
+namespace Gaia::Framework::Coroutines
+{
+    /**
+     * @brief Awaiter which turns a callback-based operation into an awaitable one.
+     * @tparam ResultType Type of the result passed to the callback.
+     * @details
+     *  The operation is started when the coroutine suspends, and receives a callback which
+     *  must be invoked exactly once, on any thread. The coroutine is then resumed on the scheduler,
+     *  so it never runs on the thread of the callback.
+     */
+    template <typename ResultType>
+    class CallbackAwaiter
+    {
+    public:
+        /// Callback which completes the operation.
+        using Callback = std::function<void(ResultType)>;
+        /// Function which starts the operation with the callback.
+        using Starter = std::function<void(Callback)>;
+
+    private:
+        Scheduler& Owner;
+        Starter Start;
+        std::optional<ResultType> Result;
+
+    public:
+        CallbackAwaiter(Scheduler& owner, Starter start) : Owner(owner), Start(std::move(start))
+        {}
+
+        [[nodiscard]] bool await_ready() const noexcept
+        {
+            return false;
+        }
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            // The coroutine is resumed by the scheduler, so the callback can be invoked before Start returns.
+            Start([this, handle](ResultType result){
+                this->Result.emplace(std::move(result));
+                this->Owner.Post(handle);
+            });
+        }
+        ResultType await_resume()
+        {
+            return std::move(*Result);
+        }
+    };
+}
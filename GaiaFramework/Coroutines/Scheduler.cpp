@@ -0,0 +1,93 @@
+#ifdef GAIA_FRAMEWORK_COROUTINES
+
+#include "Scheduler.hpp"
+
+namespace Gaia::Framework::Coroutines
+{
+    /// Pass the exception to the scheduler.
+    void Task::promise_type::unhandled_exception() noexcept
+    {
+        if (!Owner || !Owner->ExceptionHandler) return;
+        try
+        {
+            Owner->ExceptionHandler(std::current_exception());
+        }
+        catch (...)
+        {}
+    }
+
+    /// Unregister the task from its scheduler.
+    Task::promise_type::~promise_type()
+    {
+        if (Owner) Owner->TaskCount.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    /// Destroy the coroutines which are still ready or sleeping.
+    Scheduler::~Scheduler()
+    {
+        while (auto handle = ReadyHandles.Pop())
+        {
+            handle->destroy();
+        }
+        while (!Timers.empty())
+        {
+            auto handle = Timers.top().Handle;
+            Timers.pop();
+            handle.destroy();
+        }
+    }
+
+    /// Start a task on this scheduler.
+    void Scheduler::Spawn(Task task)
+    {
+        auto handle = task.Release();
+        if (!handle) return;
+        handle.promise().Owner = this;
+        TaskCount.fetch_add(1, std::memory_order_relaxed);
+        Post(handle);
+    }
+
+    /// Queue a suspended coroutine to be resumed in the next Run().
+    void Scheduler::Post(std::coroutine_handle<> handle)
+    {
+        ReadyHandles.Push(handle);
+        ReadyCount.fetch_add(1, std::memory_order_release);
+    }
+
+    /// Add a sleeping coroutine into the timer heap.
+    void Scheduler::AddTimer(Clock::time_point deadline, std::coroutine_handle<> handle)
+    {
+        Timers.push(Timer{deadline, NextTimerSequence++, handle});
+    }
+
+    /// Resume coroutines whose deadlines have passed, and coroutines in the ready queue.
+    std::size_t Scheduler::Run()
+    {
+        std::size_t resumed_count = 0;
+
+        auto now = Clock::now();
+        while (!Timers.empty() && Timers.top().Deadline <= now)
+        {
+            auto handle = Timers.top().Handle;
+            Timers.pop();
+            handle.resume();
+            ++resumed_count;
+        }
+
+        // Only coroutines posted before this point are resumed in this run.
+        auto ready_count = ReadyCount.load(std::memory_order_acquire);
+        for (std::size_t index = 0; index < ready_count; ++index)
+        {
+            auto handle = ReadyHandles.Pop();
+            // A push still in progress will be seen in the next run.
+            if (!handle) break;
+            ReadyCount.fetch_sub(1, std::memory_order_relaxed);
+            handle->resume();
+            ++resumed_count;
+        }
+
+        return resumed_count;
+    }
+}
+
+#endif
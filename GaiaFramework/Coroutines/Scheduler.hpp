@@ -0,0 +1,146 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <optional>
+#include <queue>
+#include <vector>
+
+#include "Task.hpp"
+#include "../Containers/MpscQueue.hpp"
+
+namespace Gaia::Framework::Coroutines
+{
+    /**
+     * @brief Single-threaded executor of coroutine tasks.
+     * @details
+     *  Coroutines only run in Run(), on the thread which invokes it,
+     *  so code of tasks needs no synchronization with each other.
+     *  Suspended coroutines hold no thread: any thread can post them back into the ready queue,
+     *  and sleeping coroutines wait in a timer heap.
+     */
+    class Scheduler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// Awaiter which resumes the coroutine on its scheduler after the deadline.
+        class SleepAwaiter
+        {
+        private:
+            Scheduler& Owner;
+            Clock::time_point Deadline;
+
+        public:
+            SleepAwaiter(Scheduler& owner, Clock::time_point deadline) noexcept : Owner(owner), Deadline(deadline)
+            {}
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return Deadline <= Clock::now();
+            }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                Owner.AddTimer(Deadline, handle);
+            }
+            void await_resume() const noexcept
+            {}
+        };
+
+    private:
+        /// Coroutine waiting for its deadline.
+        struct Timer
+        {
+            Clock::time_point Deadline;
+            /// Order of timers with the same deadline.
+            std::uint64_t Sequence;
+            std::coroutine_handle<> Handle;
+
+            bool operator>(const Timer& other) const noexcept
+            {
+                return Deadline != other.Deadline ? Deadline > other.Deadline : Sequence > other.Sequence;
+            }
+        };
+
+        /// Coroutines ready to be resumed, posted from any thread.
+        Containers::MpscQueue<std::coroutine_handle<>> ReadyHandles;
+        /// Count of coroutines in the ready queue.
+        std::atomic<std::size_t> ReadyCount {0};
+        /// Sleeping coroutines, ordered by the earliest deadline first, only used by the running thread.
+        std::priority_queue<Timer, std::vector<Timer>, std::greater<>> Timers;
+        /// Sequence of the next timer.
+        std::uint64_t NextTimerSequence {0};
+        /// Count of spawned tasks which have not returned.
+        std::atomic<std::size_t> TaskCount {0};
+        /// Receives exceptions escaped from tasks.
+        std::function<void(std::exception_ptr)> ExceptionHandler;
+
+        /// Add a sleeping coroutine into the timer heap.
+        void AddTimer(Clock::time_point deadline, std::coroutine_handle<> handle);
+
+        friend struct Task::promise_type;
+
+    public:
+        Scheduler() = default;
+        Scheduler(const Scheduler&) = delete;
+        Scheduler& operator=(const Scheduler&) = delete;
+        /// Destroy the coroutines which are still ready or sleeping.
+        ~Scheduler();
+
+        /**
+         * @brief Start a task on this scheduler.
+         * @details The task begins in the next Run(), multi-threads safe to use.
+         */
+        void Spawn(Task task);
+
+        /// Queue a suspended coroutine to be resumed in the next Run(), multi-threads safe to use.
+        void Post(std::coroutine_handle<> handle);
+
+        /**
+         * @brief Resume coroutines whose deadlines have passed, and coroutines in the ready queue.
+         * @return Count of resumed coroutines.
+         * @details
+         *  Coroutines posted while running are resumed in the next Run(),
+         *  so a coroutine which keeps rescheduling itself can not block the caller.
+         */
+        std::size_t Run();
+
+        /// Suspend the current task for the given duration, it must be awaited in a task of this scheduler.
+        [[nodiscard]] SleepAwaiter Sleep(Clock::duration duration) noexcept
+        {
+            return {*this, Clock::now() + duration};
+        }
+        /// Suspend the current task until the given time, it must be awaited in a task of this scheduler.
+        [[nodiscard]] SleepAwaiter SleepUntil(Clock::time_point deadline) noexcept
+        {
+            return {*this, deadline};
+        }
+
+        /// Get the earliest deadline of sleeping coroutines, only reliable on the running thread.
+        [[nodiscard]] std::optional<Clock::time_point> GetNextDeadline() const
+        {
+            if (Timers.empty()) return std::nullopt;
+            return Timers.top().Deadline;
+        }
+        /// Check whether coroutines are waiting in the ready queue.
+        [[nodiscard]] bool HasReadyTasks() const noexcept
+        {
+            return ReadyCount.load(std::memory_order_acquire) > 0;
+        }
+        /// Get the count of spawned tasks which have not returned.
+        [[nodiscard]] std::size_t GetTaskCount() const noexcept
+        {
+            return TaskCount.load(std::memory_order_relaxed);
+        }
+
+        /// Set the handler of exceptions escaped from tasks, exceptions are ignored if it is null.
+        void SetExceptionHandler(std::function<void(std::exception_ptr)> handler)
+        {
+            ExceptionHandler = std::move(handler);
+        }
+    };
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#if !defined(__cpp_impl_coroutine)
+#error "Coroutines of Gaia Framework require C++20, enable them with the WITH_COROUTINES CMake option."
+#endif
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+namespace Gaia::Framework::Coroutines
+{
+    class Scheduler;
+
+    /**
+     * @brief Detached coroutine executed by a scheduler.
+     * @details
+     *  A task is suspended when it is created, and starts when it is spawned on a scheduler.
+     *  Once spawned, the task owns itself: its frame is destroyed when it returns,
+     *  and exceptions escaping from it are passed to the exception handler of the scheduler.
+     *  A task which is never spawned is destroyed with this object.
+     */
+    class Task
+    {
+    public:
+        /// Promise of a task.
+        struct promise_type
+        {
+            /// Scheduler which the task is spawned on.
+            Scheduler* Owner {nullptr};
+
+            Task get_return_object() noexcept
+            {
+                return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+            std::suspend_always initial_suspend() noexcept
+            {
+                return {};
+            }
+            std::suspend_never final_suspend() noexcept
+            {
+                return {};
+            }
+            void return_void() noexcept
+            {}
+            /// Pass the exception to the scheduler, defined in Scheduler.cpp.
+            void unhandled_exception() noexcept;
+
+            /// Unregister the task from its scheduler, defined in Scheduler.cpp.
+            ~promise_type();
+        };
+
+    private:
+        /// Handle of the coroutine, null after it is spawned.
+        std::coroutine_handle<promise_type> Handle;
+
+        explicit Task(std::coroutine_handle<promise_type> handle) noexcept : Handle(handle)
+        {}
+
+    public:
+        Task(Task&& other) noexcept : Handle(std::exchange(other.Handle, nullptr))
+        {}
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                if (Handle) Handle.destroy();
+                Handle = std::exchange(other.Handle, nullptr);
+            }
+            return *this;
+        }
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        /// Destroy the coroutine if it has not been spawned.
+        ~Task()
+        {
+            if (Handle) Handle.destroy();
+        }
+
+        /// Release the ownership of the coroutine, used by the scheduler to spawn it.
+        [[nodiscard]] std::coroutine_handle<promise_type> Release() noexcept
+        {
+            return std::exchange(Handle, nullptr);
+        }
+    };
+}
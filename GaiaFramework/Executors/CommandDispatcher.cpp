@@ -0,0 +1,179 @@
+#include "CommandDispatcher.hpp"
+
+#include <algorithm>
+
+namespace Gaia::Framework::Executors
+{
+    /// Maximum count of invocations a lane executes before it yields its thread to other lanes.
+    static constexpr std::size_t LaneBatchSize = 16;
+
+    /// Execute the remaining invocations and stop the thread pool.
+    CommandDispatcher::~CommandDispatcher()
+    {
+        Stop();
+    }
+
+    /// Start the thread pool.
+    void CommandDispatcher::Start(std::size_t thread_count, ExceptionHandler handler)
+    {
+        Stop();
+        std::unique_lock lock(LanesMutex);
+        Handler = std::move(handler);
+        Pool = std::make_unique<ThreadPool>(thread_count);
+        Stopping = false;
+    }
+
+    /// Execute the remaining invocations and stop the thread pool.
+    void CommandDispatcher::Stop()
+    {
+        std::unique_lock lock(LanesMutex);
+        if (!Pool || Stopping) return;
+        Stopping = true;
+        auto* pool = Pool.get();
+        lock.unlock();
+        // Queued and parked invocations are still executed.
+        pool->Shutdown();
+        lock.lock();
+        Pool.reset();
+    }
+
+    /// Check whether the thread pool is running or not.
+    bool CommandDispatcher::IsRunning()
+    {
+        std::unique_lock lock(LanesMutex);
+        return Pool && !Stopping;
+    }
+
+    /// Find or create the lane of the given command.
+    CommandDispatcher::Lane& CommandDispatcher::AcquireLane(const std::string& command)
+    {
+        auto& lane = Lanes[command];
+        if (!lane)
+        {
+            lane = std::make_unique<Lane>();
+            lane->Name = command;
+            lane->Options = DefaultOptions;
+        }
+        return *lane;
+    }
+
+    /// Set options of the given command.
+    void CommandDispatcher::SetOptions(const std::string& command, const CommandOptions& options)
+    {
+        std::unique_lock lock(LanesMutex);
+        auto& lane = AcquireLane(command);
+        lane.Options = options;
+        lane.Options.QueueCapacity = std::max<std::size_t>(lane.Options.QueueCapacity, 1);
+        lane.Options.Concurrency = std::max<std::size_t>(lane.Options.Concurrency, 1);
+    }
+
+    /// Set options of commands without specific options.
+    void CommandDispatcher::SetDefaultOptions(const CommandOptions& options)
+    {
+        std::unique_lock lock(LanesMutex);
+        DefaultOptions = options;
+        DefaultOptions.QueueCapacity = std::max<std::size_t>(DefaultOptions.QueueCapacity, 1);
+        DefaultOptions.Concurrency = std::max<std::size_t>(DefaultOptions.Concurrency, 1);
+    }
+
+    /// Queue an invocation of the given command.
+    bool CommandDispatcher::Dispatch(const std::string& command, std::function<void()> invocation)
+    {
+        std::unique_lock lock(LanesMutex);
+        if (!Pool || Stopping) return false;
+        auto* pool = Pool.get();
+        auto& lane = AcquireLane(command);
+
+        // The queue also counts as full while invocations are parked, so they are not overtaken.
+        if (lane.Queue.size() >= lane.Options.QueueCapacity || !lane.Overflow.empty())
+        {
+            switch (lane.Options.Policy)
+            {
+                case OverflowPolicy::Reject:
+                    ++lane.Statistics.RejectedCount;
+                    return false;
+                case OverflowPolicy::DropOldest:
+                    lane.Queue.pop_front();
+                    ++lane.Statistics.DroppedCount;
+                    break;
+                case OverflowPolicy::Block:
+                    // Waiting here would stall every later message of the dispatching thread.
+                    lane.Overflow.push_back(std::move(invocation));
+                    ++lane.Statistics.ParkedCount;
+                    return true;
+            }
+        }
+
+        lane.Queue.push_back(std::move(invocation));
+        if (lane.RunningCount < lane.Options.Concurrency)
+        {
+            ++lane.RunningCount;
+            // Submitted under the lock, so the pool can not be shut down before it receives the invocation.
+            pool->Submit([this, &lane, pool]{
+                this->ExecuteLane(lane, *pool);
+            });
+        }
+        return true;
+    }
+
+    /// Execute queued invocations of the lane, and release its slot when the queue is empty.
+    void CommandDispatcher::ExecuteLane(Lane& lane, ThreadPool& pool)
+    {
+        for (std::size_t executed_count = 0; executed_count < LaneBatchSize; ++executed_count)
+        {
+            std::unique_lock lock(LanesMutex);
+            if (lane.Queue.empty())
+            {
+                --lane.RunningCount;
+                return;
+            }
+            auto invocation = std::move(lane.Queue.front());
+            lane.Queue.pop_front();
+            // Parked invocations are queued behind the queued ones, so the arrival order is kept.
+            if (!lane.Overflow.empty())
+            {
+                lane.Queue.push_back(std::move(lane.Overflow.front()));
+                lane.Overflow.pop_front();
+            }
+            ++lane.Statistics.ExecutedCount;
+            lock.unlock();
+
+            try
+            {
+                invocation();
+            }
+            catch (...)
+            {
+                lock.lock();
+                ++lane.Statistics.FailedCount;
+                lock.unlock();
+                if (Handler)
+                {
+                    try
+                    {
+                        Handler(lane.Name, std::current_exception());
+                    }
+                    catch (...)
+                    {}
+                }
+            }
+        }
+
+        // Yield the thread to other lanes, and keep the slot of this lane for its remaining invocations.
+        pool.Submit([this, &lane, &pool]{
+            this->ExecuteLane(lane, pool);
+        });
+    }
+
+    /// Get the statistics of the given command.
+    CommandDispatcher::CommandStatistics CommandDispatcher::GetStatistics(const std::string& command)
+    {
+        std::unique_lock lock(LanesMutex);
+        auto finder = Lanes.find(command);
+        if (finder == Lanes.end()) return {};
+        auto statistics = finder->second->Statistics;
+        statistics.QueuedCount = finder->second->Queue.size();
+        statistics.OverflowCount = finder->second->Overflow.size();
+        return statistics;
+    }
+}
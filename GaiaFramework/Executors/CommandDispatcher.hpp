@@ -0,0 +1,138 @@
+#pragma once
+
+#include <string>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <exception>
+#include <unordered_map>
+#include <cstdint>
+
+#include "ThreadPool.hpp"
+
+namespace Gaia::Framework::Executors
+{
+    /**
+     * @brief Dispatcher which executes commands on a thread pool, with a bounded queue for every command.
+     * @details
+     *  Every command has its own queue and concurrency limit,
+     *  so a slow or flooded command will not block other commands.
+     *  Invocations of the same command start in their arrival order.
+     */
+    class CommandDispatcher
+    {
+    public:
+        /// Policy to apply when the queue of a command is full.
+        enum class OverflowPolicy
+        {
+            Reject = 0,     ///< Discard the new invocation.
+            DropOldest = 1, ///< Discard the oldest queued invocation to make room for the new one.
+            Block = 2       ///< Park the new invocation until the queue has free space, without blocking the caller.
+        };
+
+        /// Options of a command.
+        struct CommandOptions
+        {
+            /// Maximum count of queued invocations.
+            std::size_t QueueCapacity {64};
+            /// Policy to apply when the queue is full.
+            OverflowPolicy Policy {OverflowPolicy::Reject};
+            /// Maximum count of invocations executed at the same time.
+            std::size_t Concurrency {1};
+        };
+
+        /// Receives the name of the command and the exception thrown by one of its invocations.
+        using ExceptionHandler = std::function<void(const std::string&, std::exception_ptr)>;
+
+        /// Statistics of a command.
+        struct CommandStatistics
+        {
+            /// Count of executed invocations.
+            std::uint64_t ExecutedCount {0};
+            /// Count of invocations which threw exceptions.
+            std::uint64_t FailedCount {0};
+            /// Count of invocations rejected because the queue was full.
+            std::uint64_t RejectedCount {0};
+            /// Count of queued invocations dropped to make room for new ones.
+            std::uint64_t DroppedCount {0};
+            /// Count of invocations parked in the overflow list because the queue was full.
+            std::uint64_t ParkedCount {0};
+            /// Count of invocations waiting in the queue.
+            std::size_t QueuedCount {0};
+            /// Count of invocations waiting in the overflow list.
+            std::size_t OverflowCount {0};
+        };
+
+    private:
+        /// Queue and state of a command.
+        struct Lane
+        {
+            /// Name of the command.
+            std::string Name;
+            CommandOptions Options;
+            /// Invocations waiting to be executed.
+            std::deque<std::function<void()>> Queue;
+            /// Invocations parked by the block policy, moved into the queue as it has free space.
+            std::deque<std::function<void()>> Overflow;
+            /// Count of invocations being executed or scheduled on the pool.
+            std::size_t RunningCount {0};
+            CommandStatistics Statistics;
+        };
+
+        /// Mutex for lanes and options.
+        std::mutex LanesMutex;
+        /// Lanes of commands.
+        std::unordered_map<std::string, std::unique_ptr<Lane>> Lanes;
+        /// Options of commands without specific options.
+        CommandOptions DefaultOptions;
+
+        /// Pool to execute invocations, null if the dispatcher is not started.
+        std::unique_ptr<ThreadPool> Pool;
+        /// Whether the dispatcher is stopping or not, new invocations will be rejected.
+        bool Stopping {false};
+        /// Receives exceptions thrown by invocations, exceptions are discarded if it is null.
+        ExceptionHandler Handler;
+
+        /// Find or create the lane of the given command.
+        Lane& AcquireLane(const std::string& command);
+        /// Execute queued invocations of the lane, and release its slot when the queue is empty.
+        void ExecuteLane(Lane& lane, ThreadPool& pool);
+
+    public:
+        /// Execute the remaining invocations and stop the thread pool.
+        ~CommandDispatcher();
+
+        /**
+         * @brief Start the thread pool.
+         * @param thread_count Count of threads in the pool.
+         * @param handler Receives exceptions thrown by invocations, it is invoked on the pool threads.
+         */
+        void Start(std::size_t thread_count, ExceptionHandler handler = nullptr);
+        /// Execute the remaining invocations and stop the thread pool.
+        void Stop();
+        /// Check whether the thread pool is running or not.
+        [[nodiscard]] bool IsRunning();
+
+        /// Set options of the given command.
+        void SetOptions(const std::string& command, const CommandOptions& options);
+        /// Set options of commands without specific options.
+        void SetDefaultOptions(const CommandOptions& options);
+
+        /**
+         * @brief Queue an invocation of the given command.
+         * @param command Name of the command.
+         * @param invocation Functor to execute on the thread pool.
+         * @retval true The invocation is queued.
+         * @retval false The invocation is rejected because the queue is full or the dispatcher is not running.
+         * @details
+         *  It never blocks, so it is safe to dispatch from the message thread.
+         *  With the block policy, invocations beyond the capacity are parked in an unbounded overflow list,
+         *  and they are queued in their arrival order as the queue has free space.
+         */
+        bool Dispatch(const std::string& command, std::function<void()> invocation);
+
+        /// Get the statistics of the given command.
+        [[nodiscard]] CommandStatistics GetStatistics(const std::string& command);
+    };
+}
@@ -0,0 +1,61 @@
+#include "Strand.hpp"
+
+namespace Gaia::Framework::Executors
+{
+    /// Maximum count of tasks a strand executes before it yields its thread to other strands.
+    static constexpr std::size_t StrandBatchSize = 16;
+
+    /// Bind the thread pool to execute tasks.
+    Strand::Strand(ThreadPool& pool, ThreadPool::ExceptionHandler handler) : Pool(pool), Handler(std::move(handler))
+    {}
+
+    /// Post a task to execute after all previously posted tasks.
+    void Strand::Post(std::function<void()> task)
+    {
+        std::unique_lock lock(TasksMutex);
+        Tasks.push_back(std::move(task));
+        if (Scheduled) return;
+        Scheduled = true;
+        lock.unlock();
+        Pool.Submit([this]{
+            this->ExecuteTasks();
+        });
+    }
+
+    /// Execute queued tasks, and reschedule this strand if tasks are left.
+    void Strand::ExecuteTasks()
+    {
+        for (std::size_t executed_count = 0; executed_count < StrandBatchSize; ++executed_count)
+        {
+            std::unique_lock lock(TasksMutex);
+            if (Tasks.empty())
+            {
+                Scheduled = false;
+                return;
+            }
+            auto task = std::move(Tasks.front());
+            Tasks.pop_front();
+            lock.unlock();
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                if (!Handler) continue;
+                try
+                {
+                    Handler(std::current_exception());
+                }
+                catch (...)
+                {}
+            }
+        }
+
+        // Yield the thread to other strands, tasks left will be executed in order by the next schedule.
+        Pool.Submit([this]{
+            this->ExecuteTasks();
+        });
+    }
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <functional>
+
+#include "ThreadPool.hpp"
+
+namespace Gaia::Framework::Executors
+{
+    /**
+     * @brief Serial executor on a shared thread pool.
+     * @details
+     *  Tasks posted to a strand are executed one by one in their posting order,
+     *  while tasks of different strands are executed in parallel on the pool.
+     *  A strand only occupies a thread of the pool while it has tasks.
+     *  Exceptions thrown by tasks are passed to the exception handler, and the following tasks still run.
+     */
+    class Strand
+    {
+    private:
+        /// Pool to execute tasks, it should outlive this strand.
+        ThreadPool& Pool;
+
+        /// Mutex for the task queue.
+        std::mutex TasksMutex;
+        /// Tasks waiting to be executed.
+        std::deque<std::function<void()>> Tasks;
+        /// Whether the strand is scheduled on the pool or not.
+        bool Scheduled {false};
+        /// Receives exceptions thrown by tasks, exceptions are discarded if it is null.
+        ThreadPool::ExceptionHandler Handler;
+
+        /// Execute queued tasks, and reschedule this strand if tasks are left.
+        void ExecuteTasks();
+
+    public:
+        /**
+         * @brief Bind the thread pool to execute tasks.
+         * @param pool Pool to execute tasks, it should outlive this strand.
+         * @param handler Receives exceptions thrown by tasks, it is invoked on the pool threads.
+         */
+        explicit Strand(ThreadPool& pool, ThreadPool::ExceptionHandler handler = nullptr);
+
+        Strand(const Strand&) = delete;
+        Strand& operator=(const Strand&) = delete;
+
+        /// Post a task to execute after all previously posted tasks.
+        void Post(std::function<void()> task);
+    };
+}
@@ -0,0 +1,80 @@
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace Gaia::Framework::Executors
+{
+    /// Start the given count of workers.
+    ThreadPool::ThreadPool(std::size_t thread_count, ExceptionHandler handler) : Handler(std::move(handler))
+    {
+        thread_count = std::max<std::size_t>(thread_count, 1);
+        Workers.reserve(thread_count);
+        for (std::size_t index = 0; index < thread_count; ++index)
+        {
+            Workers.push_back(std::make_unique<Gaia::Background::BackgroundWorker>(
+                    [this](const std::atomic_bool&){
+                        this->ExecuteTasks();
+                    }));
+            Workers.back()->Start();
+        }
+    }
+
+    /// Execute the remaining tasks and stop all workers.
+    ThreadPool::~ThreadPool()
+    {
+        Shutdown();
+    }
+
+    /// Submit a task to execute on a worker.
+    void ThreadPool::Submit(std::function<void()> task)
+    {
+        std::unique_lock lock(TasksMutex);
+        Tasks.push_back(std::move(task));
+        lock.unlock();
+        TasksCondition.notify_one();
+    }
+
+    /// Execute the remaining tasks and stop all workers.
+    void ThreadPool::Shutdown()
+    {
+        std::unique_lock lock(TasksMutex);
+        Stopping = true;
+        lock.unlock();
+        TasksCondition.notify_all();
+        for (auto& worker : Workers)
+        {
+            worker->Stop();
+        }
+    }
+
+    /// Execute tasks until the pool is shutting down and no task is left.
+    void ThreadPool::ExecuteTasks()
+    {
+        while (true)
+        {
+            std::unique_lock lock(TasksMutex);
+            TasksCondition.wait(lock, [this]{
+                return !Tasks.empty() || Stopping;
+            });
+            if (Tasks.empty()) break;
+            auto task = std::move(Tasks.front());
+            Tasks.pop_front();
+            lock.unlock();
+
+            try
+            {
+                task();
+            }
+            catch (...)
+            {
+                if (!Handler) continue;
+                try
+                {
+                    Handler(std::current_exception());
+                }
+                catch (...)
+                {}
+            }
+        }
+    }
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <condition_variable>
+#include <GaiaBackground/GaiaBackground.hpp>
+
+namespace Gaia::Framework::Executors
+{
+    /**
+     * @brief Fixed count of background workers which execute submitted tasks in FIFO order.
+     * @details
+     *  Exceptions thrown by tasks are caught and passed to the exception handler,
+     *  so a failed task will not stop its worker.
+     *  Tasks can submit further tasks, including during the shutdown, they will all be executed.
+     */
+    class ThreadPool
+    {
+    public:
+        /// Receives exceptions thrown by tasks, it is invoked on the worker which executed the task.
+        using ExceptionHandler = std::function<void(std::exception_ptr)>;
+
+    private:
+        /// Mutex for the task queue.
+        std::mutex TasksMutex;
+        /// Notified when a task is submitted or the pool is shutting down.
+        std::condition_variable TasksCondition;
+        /// Tasks waiting to be executed.
+        std::deque<std::function<void()>> Tasks;
+        /// Whether the pool is shutting down or not.
+        bool Stopping {false};
+        /// Receives exceptions thrown by tasks, exceptions are discarded if it is null.
+        ExceptionHandler Handler;
+
+        /// Background workers which execute tasks.
+        std::vector<std::unique_ptr<Gaia::Background::BackgroundWorker>> Workers;
+
+        /// Execute tasks until the pool is shutting down and no task is left.
+        void ExecuteTasks();
+
+    public:
+        /**
+         * @brief Start the given count of workers.
+         * @param thread_count Count of workers, at least one worker will be started.
+         * @param handler Receives exceptions thrown by tasks, exceptions are discarded if it is null.
+         */
+        explicit ThreadPool(std::size_t thread_count, ExceptionHandler handler = nullptr);
+        /// Execute the remaining tasks and stop all workers.
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        /// Submit a task to execute on a worker.
+        void Submit(std::function<void()> task);
+
+        /// Execute the remaining tasks and stop all workers, this pool can not be restarted.
+        void Shutdown();
+
+        /// Get the count of workers.
+        [[nodiscard]] inline std::size_t GetThreadCount() const noexcept
+        {
+            return Workers.size();
+        }
+    };
+}
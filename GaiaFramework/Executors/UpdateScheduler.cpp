@@ -0,0 +1,147 @@
+#include "UpdateScheduler.hpp"
+#include <thread>
+#include <algorithm>
+
+namespace Gaia::Framework::Executors
+{
+    /// Construct a scheduler with the default options.
+    UpdateScheduler::UpdateScheduler() : UpdateScheduler(Options{})
+    {}
+
+    /// Construct a scheduler with the given options.
+    UpdateScheduler::UpdateScheduler(const Options& options)
+    {
+        SetOptions(options);
+    }
+
+    /// Change the options.
+    void UpdateScheduler::SetOptions(const Options& options)
+    {
+        Settings = options;
+        Period = Settings.Frequency > 0 ?
+                std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / Settings.Frequency)) :
+                Clock::duration::zero();
+        EventsEnabled = Settings.Mode == UpdateMode::EventDriven;
+    }
+
+    /// Start a new timeline from now.
+    void UpdateScheduler::Reset()
+    {
+        FrameStartTime = Clock::now();
+        FrameDueTime = FrameStartTime;
+        FrameDelta = Clock::duration::zero();
+    }
+
+    /// Sleep until the given time, the last part of the sleep is spent spinning.
+    void UpdateScheduler::SleepUntil(Clock::time_point deadline) const
+    {
+        if (deadline - Clock::now() > Settings.SpinDuration)
+        {
+            std::this_thread::sleep_until(deadline - Settings.SpinDuration);
+        }
+        while (Clock::now() < deadline)
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /// Block until events are notified, the wake time passes, or the idle timeout passes.
+    void UpdateScheduler::WaitForEvents(std::optional<Clock::time_point> wake_time)
+    {
+        auto deadline = Clock::now() + Settings.IdleTimeout;
+        if (wake_time.has_value()) deadline = std::min(deadline, *wake_time);
+
+        std::unique_lock lock(EventsMutex);
+        EventsCondition.wait_until(lock, deadline, [this]{
+            return EventsPending;
+        });
+        EventsPending = false;
+        lock.unlock();
+
+        // Bursts of events are merged into frames of the target rate.
+        if (Period > Clock::duration::zero())
+        {
+            SleepUntil(FrameStartTime + Period);
+        }
+    }
+
+    /// Record the duration of the finished frame.
+    void UpdateScheduler::RecordFrame(Clock::duration duration)
+    {
+        auto microseconds = std::chrono::duration_cast<std::chrono::microseconds>(duration);
+        std::unique_lock lock(StatisticsMutex);
+        ++Statistics.FrameCount;
+        if (Period > Clock::duration::zero() && duration > Period) ++Statistics.DeadlineMissCount;
+        TotalFrameDuration += duration;
+        Statistics.LastFrameDuration = microseconds;
+        Statistics.MaxFrameDuration = std::max(Statistics.MaxFrameDuration, microseconds);
+        Statistics.AverageFrameDuration = std::chrono::duration_cast<std::chrono::microseconds>(
+                TotalFrameDuration / Statistics.FrameCount);
+    }
+
+    /// Finish the current frame and block until the next frame is due.
+    void UpdateScheduler::WaitForFrame(std::optional<Clock::time_point> wake_time)
+    {
+        auto now = Clock::now();
+        RecordFrame(now - FrameStartTime);
+
+        switch (Settings.Mode)
+        {
+            case UpdateMode::Fixed:
+                if (Period > Clock::duration::zero())
+                {
+                    FrameDueTime += Period;
+                    auto catch_up_limit = Period * static_cast<long>(Settings.MaxCatchUpFrames);
+                    if (now - FrameDueTime > catch_up_limit)
+                    {
+                        std::unique_lock lock(StatisticsMutex);
+                        Statistics.SkippedFrameCount += static_cast<std::uint64_t>((now - FrameDueTime) / Period);
+                        lock.unlock();
+                        FrameDueTime = now;
+                    }
+                    SleepUntil(FrameDueTime);
+                }
+                break;
+            case UpdateMode::Variable:
+                if (Period > Clock::duration::zero())
+                {
+                    SleepUntil(FrameStartTime + Period);
+                }
+                break;
+            case UpdateMode::EventDriven:
+                WaitForEvents(wake_time);
+                break;
+        }
+
+        auto start_time = Clock::now();
+        FrameDelta = Settings.Mode == UpdateMode::Fixed && Period > Clock::duration::zero() ?
+                Period : start_time - FrameStartTime;
+        FrameStartTime = start_time;
+    }
+
+    /// Wake up the scheduler in event-driven mode.
+    void UpdateScheduler::Notify()
+    {
+        if (!EventsEnabled.load(std::memory_order_relaxed)) return;
+        std::unique_lock lock(EventsMutex);
+        EventsPending = true;
+        lock.unlock();
+        EventsCondition.notify_one();
+    }
+
+    /// Get the statistics of frames.
+    UpdateScheduler::FrameStatistics UpdateScheduler::GetStatistics() const
+    {
+        std::unique_lock lock(StatisticsMutex);
+        return Statistics;
+    }
+
+    /// Parse the name of a mode.
+    std::optional<UpdateScheduler::UpdateMode> UpdateScheduler::ParseMode(const std::string& name)
+    {
+        if (name == "fixed") return UpdateMode::Fixed;
+        if (name == "variable") return UpdateMode::Variable;
+        if (name == "event") return UpdateMode::EventDriven;
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <cstdint>
+
+namespace Gaia::Framework::Executors
+{
+    /**
+     * @brief Paces the frames of a main loop.
+     * @details
+     *  WaitForFrame() is invoked between two frames, it records the duration of the finished frame
+     *  and blocks until the next frame is due. Sleeps are precise: the thread sleeps until shortly before
+     *  the deadline, and spins for the rest of the time, which the coarse sleep of the system can not resolve.
+     */
+    class UpdateScheduler
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        /// Modes of pacing frames.
+        enum class UpdateMode
+        {
+            /// Frames start on a fixed grid of periods, late frames are caught up back to back.
+            Fixed,
+            /// Frames start at least one period after the start of the previous frame.
+            Variable,
+            /// Frames start when events are notified or wake times pass, at most once per period.
+            EventDriven
+        };
+
+        /// Options of the scheduler.
+        struct Options
+        {
+            UpdateMode Mode {UpdateMode::Variable};
+            /// Target count of frames per second, frames are not limited if it is 0.
+            double Frequency {100.0};
+            /// The last part of every sleep is spent spinning for precise frame timing.
+            std::chrono::microseconds SpinDuration {200};
+            /// In fixed mode, frames late more than this count of periods are skipped instead of caught up.
+            unsigned int MaxCatchUpFrames {5};
+            /// In event-driven mode, a frame starts after this time without events.
+            std::chrono::milliseconds IdleTimeout {1000};
+        };
+
+        /// Statistics of frames.
+        struct FrameStatistics
+        {
+            /// Count of finished frames.
+            std::uint64_t FrameCount {0};
+            /// Count of frames which took longer than the period.
+            std::uint64_t DeadlineMissCount {0};
+            /// Count of frames skipped in fixed mode because they were too late to catch up.
+            std::uint64_t SkippedFrameCount {0};
+            /// Duration of the last frame.
+            std::chrono::microseconds LastFrameDuration {0};
+            /// Average duration of frames.
+            std::chrono::microseconds AverageFrameDuration {0};
+            /// Maximum duration of frames.
+            std::chrono::microseconds MaxFrameDuration {0};
+        };
+
+    private:
+        Options Settings;
+        /// Period of frames, 0 if frames are not limited.
+        Clock::duration Period {0};
+
+        /// Start time of the current frame.
+        Clock::time_point FrameStartTime {Clock::now()};
+        /// In fixed mode, the scheduled start time of the current frame.
+        Clock::time_point FrameDueTime {FrameStartTime};
+        /// Time between the starts of the current frame and the previous one.
+        Clock::duration FrameDelta {0};
+
+        /// Mutex for statistics.
+        mutable std::mutex StatisticsMutex;
+        FrameStatistics Statistics;
+        /// Total duration of frames, used to compute the average.
+        Clock::duration TotalFrameDuration {0};
+
+        /// Mutex for notified events.
+        std::mutex EventsMutex;
+        /// Notified when events happen in event-driven mode.
+        std::condition_variable EventsCondition;
+        /// Whether events have happened since the current frame started or not.
+        bool EventsPending {false};
+        /// Whether events should be notified or not, only true in event-driven mode.
+        std::atomic_bool EventsEnabled {false};
+
+        /// Sleep until the given time, the last part of the sleep is spent spinning.
+        void SleepUntil(Clock::time_point deadline) const;
+        /// Block until events are notified, the wake time passes, or the idle timeout passes.
+        void WaitForEvents(std::optional<Clock::time_point> wake_time);
+        /// Record the duration of the finished frame.
+        void RecordFrame(Clock::duration duration);
+
+    public:
+        /// Construct a scheduler with the default options.
+        UpdateScheduler();
+        /// Construct a scheduler with the given options.
+        explicit UpdateScheduler(const Options& options);
+
+        /// Change the options, takes effect from the next frame.
+        void SetOptions(const Options& options);
+        /// Get the options.
+        [[nodiscard]] inline const Options& GetOptions() const noexcept
+        {
+            return Settings;
+        }
+
+        /// Start a new timeline from now, the current time becomes the start of the first frame.
+        void Reset();
+
+        /**
+         * @brief Finish the current frame and block until the next frame is due.
+         * @param wake_time In event-driven mode, the next frame starts no later than this time,
+         *                  usually the earliest deadline of timers.
+         */
+        void WaitForFrame(std::optional<Clock::time_point> wake_time = std::nullopt);
+
+        /// Wake up the scheduler in event-driven mode, multi-threads safe to use, ignored in other modes.
+        void Notify();
+
+        /**
+         * @brief Get the time step of the current frame.
+         * @return The period in fixed mode, otherwise the time since the start of the previous frame.
+         */
+        [[nodiscard]] inline Clock::duration GetFrameDelta() const noexcept
+        {
+            return FrameDelta;
+        }
+
+        /// Get the statistics of frames, multi-threads safe to use.
+        [[nodiscard]] FrameStatistics GetStatistics() const;
+
+        /// Parse the name of a mode: "fixed", "variable" or "event", returns std::nullopt if it is unknown.
+        static std::optional<UpdateMode> ParseMode(const std::string& name);
+    };
+}
@@ -56,7 +56,10 @@ namespace Gaia::Framework
                     << option_host << ":" << option_port << std::endl;
                 service->Install();
                 std::cout << "Service " << service->Name << " initialized." << std::endl;
-                while (service->Update());
+                while (service->Update())
+                {
+                    service->WaitForUpdate();
+                }
                 service->Uninstall();
                 std::cout << "Service " << service->Name << " stopped." << std::endl;
             }catch (std::exception& error)
@@ -3,6 +3,8 @@
 #include <future>
 #include <iostream>
 #include <utility>
+#include <algorithm>
+#include <vector>
 #include <tbb/tbb.h>
 
 namespace Gaia::Framework
@@ -14,14 +16,34 @@ namespace Gaia::Framework
         {
             try
             {
-                this->Subscriber->consume();
-                auto current_time = std::chrono::system_clock::now();
-                if (current_time- this->LastHeartBeatTime > std::chrono::seconds(1))
+                // The subscriber is not thread-safe, so deferred channels are subscribed here.
+                std::unique_lock pending_lock(this->PendingSubscriptionsMutex);
+                auto pending_subscriptions = std::move(this->PendingSubscriptions);
+                this->PendingSubscriptions.clear();
+                pending_lock.unlock();
+                for (auto channel = pending_subscriptions.begin(); channel != pending_subscriptions.end(); ++channel)
                 {
-                    this->NameResolver->Update();
+                    try
+                    {
+                        this->Subscriber->subscribe(*channel);
+                    }
+                    catch (sw::redis::Error&)
+                    {
+                        // Channels not subscribed yet are requested again, otherwise their keys are never tracked.
+                        std::unique_lock restore_lock(this->PendingSubscriptionsMutex);
+                        this->PendingSubscriptions.insert(this->PendingSubscriptions.end(),
+                                                          channel, pending_subscriptions.end());
+                        throw;
+                    }
                 }
+                this->Subscriber->consume();
+            }
+            catch (sw::redis::TimeoutError&){}
+            catch (sw::redis::Error&)
+            {
+                // The subscriber is broken after a connection error, so it will throw on every consumption.
+                this->RecoverSubscriber(life_flag);
             }
-            catch (sw::redis::Error& error){}
         }
     })
     {
@@ -30,7 +52,67 @@ namespace Gaia::Framework
                 ("host,h", boost::program_options::value<std::string>()->default_value("127.0.0.1"),
                  "ip address of the Redis server.")
                 ("port,p", boost::program_options::value<unsigned int>()->default_value(6379),
-                 "port of the Redis server.");
+                 "port of the Redis server.")
+                ("log-async", "publish logs in batches on a background thread.")
+                ("log-level", boost::program_options::value<std::string>(),
+                 "minimum severity of logs to record: message, milestone, warning or error.")
+                ("log-segments", boost::program_options::value<std::string>(),
+                 "directory to write binary log segments in offline mode.")
+                ("log-rotate-size", boost::program_options::value<unsigned int>(),
+                 "rotate offline log files when they reach this size in megabytes.")
+                ("log-rotate-period", boost::program_options::value<unsigned int>(),
+                 "rotate offline log files after this period in seconds.")
+                ("log-retention", boost::program_options::value<unsigned int>(),
+                 "maximum total size of closed offline log files in megabytes.")
+                ("log-spill", boost::program_options::value<std::string>(),
+                 "file to spill unpublished logs, they will be replayed when the log service is back.")
+                ("log-throttle", boost::program_options::value<double>(),
+                 "maximum count of similar logs per second, identical logs are collapsed into summaries.")
+                ("configuration-cache", "cache configuration items in this process, "
+                                        "invalidated by reload and update notifications.")
+                ("command-threads", boost::program_options::value<unsigned int>(),
+                 "count of threads to execute commands, commands are executed on the message thread if it is 0.")
+                ("command-queue", boost::program_options::value<unsigned int>(),
+                 "maximum count of queued invocations of every command.")
+                ("message-threads", boost::program_options::value<unsigned int>(),
+                 "count of threads to handle subscription messages in per-channel strands, "
+                 "messages are handled on the message thread if it is 0.")
+                ("name-registry", "keep names in a registry and mirror the name directory locally.")
+                ("name-cache", boost::program_options::value<unsigned int>(),
+                 "cache resolved name addresses for this time in milliseconds.")
+                ("name-heartbeat-interval", boost::program_options::value<unsigned int>()->default_value(1000),
+                 "interval between two heartbeats of the service name in milliseconds.")
+                ("name-ttl-ratio", boost::program_options::value<double>()->default_value(3.0),
+                 "the service name expires after this multiple of the heartbeat interval without heartbeats.")
+                ("remote-cache", boost::program_options::value<unsigned int>(),
+                 "cache at most this count of remote values in this process, "
+                 "invalidated by keyspace notifications.")
+                ("update-mode", boost::program_options::value<std::string>(),
+                 "pacing of frames: fixed, variable or event, "
+                 "event mode only runs frames when messages or timers arrive.")
+                ("update-frequency", boost::program_options::value<double>()->default_value(100.0),
+                 "target count of frames per second, frames are not limited if it is 0.")
+                ("update-spin", boost::program_options::value<unsigned int>(),
+                 "microseconds to spin at the end of every sleep between frames, for precise frame timing.")
+                ("update-idle", boost::program_options::value<unsigned int>(),
+                 "in event mode, milliseconds after which a frame runs without events.");
+
+#ifdef GAIA_FRAMEWORK_COROUTINES
+        TaskScheduler.SetExceptionHandler([this](std::exception_ptr exception){
+            try
+            {
+                std::rethrow_exception(exception);
+            }
+            catch (std::exception& error)
+            {
+                this->Logger->RecordError("Exception escaped from coroutine task: {}", error.what());
+            }
+            catch (...)
+            {
+                this->Logger->RecordError("Unknown exception escaped from coroutine task.");
+            }
+        });
+#endif
     }
 
     /// Update this service.
@@ -38,37 +120,118 @@ namespace Gaia::Framework
     {
         if (Enable)
         {
+#ifdef GAIA_FRAMEWORK_COROUTINES
+            TaskScheduler.Run();
+#endif
             OnUpdate();
         }
         return LifeFlag.load();
     }
 
+    /// Block until the next frame is due.
+    void Service::WaitForUpdate()
+    {
+        std::optional<Executors::UpdateScheduler::Clock::time_point> wake_time;
+#ifdef GAIA_FRAMEWORK_COROUTINES
+        // Ready tasks and expired timers are handled in the next frame without waiting for events.
+        wake_time = TaskScheduler.HasReadyTasks() ? std::chrono::steady_clock::now() : TaskScheduler.GetNextDeadline();
+#endif
+        FrameScheduler.WaitForFrame(wake_time);
+    }
+
     /// Install this service.
     void Service::Install()
     {
         Enable = true;
 
+#ifdef GAIA_FRAMEWORK_COROUTINES
+        std::unique_lock waiters_lock(MessageWaitersMutex);
+        MessageWaitersClosed = false;
+        waiters_lock.unlock();
+#endif
+
         std::unique_lock lock(CommandHandlersMutex);
-        CommandHandlers.clear();
+        CommandEntries.clear();
+        CommandChannels.clear();
+        RequestChannels.clear();
+        ControlCommands = {"pause", "resume", "shutdown", "log_level"};
         lock.unlock();
 
         AddCommand("pause", [this](const std::string &content) {
             this->Enable = false;
-            this->Logger->RecordMilestone("Service paused by command. " + content);
+            this->Logger->RecordMilestone("Service paused by command. {}", content);
         });
         AddCommand("resume", [this](const std::string &content) {
             this->Enable = true;
-            this->Logger->RecordMilestone("Service resumed by command. " + content);
+            this->Logger->RecordMilestone("Service resumed by command. {}", content);
         });
         AddCommand("shutdown", [this](const std::string &content) {
             this->LifeFlag = false;
-            this->Logger->RecordMilestone("Service shutdown by command. " + content);
+            this->Logger->RecordMilestone("Service shutdown by command. {}", content);
+        });
+        AddCommand("log_level", [this](const std::string &content) {
+            auto severity = Clients::LogFormatter::ParseSeverity(content);
+            if (!severity.has_value())
+            {
+                this->Logger->RecordWarning("Invalid log level received: {}", content);
+                return;
+            }
+            this->Logger->SetMinimumSeverity(*severity);
+            this->Logger->RecordMilestone("Log level set to {} by command.",
+                                          Clients::LogFormatter::GetSeverityName(*severity));
         });
 
-        LastHeartBeatTime = std::chrono::system_clock::now();
+        if (OptionVariables.count("command-threads") && OptionVariables["command-threads"].as<unsigned int>() > 0)
+        {
+            Executors::CommandDispatcher::CommandOptions command_options;
+            if (OptionVariables.count("command-queue"))
+            {
+                command_options.QueueCapacity = OptionVariables["command-queue"].as<unsigned int>();
+            }
+            Dispatcher.SetDefaultOptions(command_options);
+            Dispatcher.Start(OptionVariables["command-threads"].as<unsigned int>(),
+                             [this](const std::string& name, std::exception_ptr exception){
+                this->RecordCommandException(name, exception);
+            });
+        }
+
+        if (OptionVariables.count("message-threads") && OptionVariables["message-threads"].as<unsigned int>() > 0)
+        {
+            MessagePool = std::make_unique<Executors::ThreadPool>(
+                    OptionVariables["message-threads"].as<unsigned int>());
+        }
+
+        auto update_options = FrameScheduler.GetOptions();
+        if (OptionVariables.count("update-mode"))
+        {
+            auto mode = Executors::UpdateScheduler::ParseMode(OptionVariables["update-mode"].as<std::string>());
+            if (mode.has_value())
+            {
+                update_options.Mode = *mode;
+            }
+            else
+            {
+                Logger->RecordWarning("Invalid update mode option: {}",
+                                      OptionVariables["update-mode"].as<std::string>());
+            }
+        }
+        if (OptionVariables.count("update-frequency"))
+        {
+            update_options.Frequency = std::max(OptionVariables["update-frequency"].as<double>(), 0.0);
+        }
+        if (OptionVariables.count("update-spin"))
+        {
+            update_options.SpinDuration = std::chrono::microseconds(OptionVariables["update-spin"].as<unsigned int>());
+        }
+        if (OptionVariables.count("update-idle"))
+        {
+            update_options.IdleTimeout = std::chrono::milliseconds(OptionVariables["update-idle"].as<unsigned int>());
+        }
+        FrameScheduler.SetOptions(update_options);
 
         OnInstall();
 
+        FrameScheduler.Reset();
         MessageUpdater.Start();
     }
 
@@ -77,44 +240,438 @@ namespace Gaia::Framework
     {
         Enable = false;
         MessageUpdater.Stop();
+        Dispatcher.Stop();
+        if (RemoteFlusher) RemoteFlusher->Stop();
+        if (RemoteWatcher) RemoteWatcher->Stop();
+        if (MessagePool)
+        {
+            // Strands are destroyed after the pool has executed their remaining messages.
+            MessagePool->Shutdown();
+            MessageStrands.clear();
+            MessagePool.reset();
+        }
+#ifdef GAIA_FRAMEWORK_COROUTINES
+        // Give waiting tasks a chance to observe the end of their messages.
+        CloseMessageWaiters();
+        TaskScheduler.Run();
+#endif
 
         OnUninstall();
     }
 
+    /// Find the command of the given name.
+    std::shared_ptr<const Service::CommandEntry> Service::FindCommand(std::string_view name)
+    {
+        std::shared_lock lock(CommandHandlersMutex);
+        auto finder = CommandEntries.find(name);
+        if (finder == CommandEntries.end())
+        {
+            lock.unlock();
+            Logger->RecordError("Unknown command received: {}", name);
+            return nullptr;
+        }
+        // The entry is shared, so the command can be executed after it is removed.
+        return finder->second;
+    }
+
+    /// Execute a command inline or on the dispatcher.
+    bool Service::ExecuteCommand(const CommandEntry& command, std::function<void()> execution)
+    {
+        if (command.IsControlCommand || !Dispatcher.IsRunning())
+        {
+            execution();
+            return true;
+        }
+        if (!Dispatcher.Dispatch(command.Name, std::move(execution)))
+        {
+            Logger->RecordWarning("Command {} rejected, its queue is full.", command.Name);
+            return false;
+        }
+        return true;
+    }
+
     /// Handle a command.
-    void Service::HandleCommand(const std::string& name, const std::string &content)
+    void Service::HandleCommand(const std::shared_ptr<const CommandEntry>& command, const std::string& content)
+    {
+        if (!command->Handler)
+        {
+            Logger->RecordError("Invalid command handler: {}", command->Name);
+            return;
+        }
+        // Commands executed on the message thread use the received content in place.
+        if (command->IsControlCommand || !Dispatcher.IsRunning())
+        {
+            try
+            {
+                command->Handler(content);
+            }
+            catch (...)
+            {
+                RecordCommandException(command->Name, std::current_exception());
+            }
+            return;
+        }
+        ExecuteCommand(*command, [command, content]{
+            command->Handler(content);
+        });
+    }
+
+    /// Log an exception thrown by a command, or by the publishing of its reply.
+    void Service::RecordCommandException(const std::string& name, std::exception_ptr exception)
+    {
+        try
+        {
+            std::rethrow_exception(exception);
+        }
+        catch (std::exception& error)
+        {
+            Logger->RecordError("Exception in command {}: {}", name, error.what());
+        }
+        catch (...)
+        {
+            Logger->RecordError("Unknown exception in command {}.", name);
+        }
+    }
+
+    /// Handle a request to a command, and publish the reply.
+    void Service::HandleRequest(std::string_view name, const std::shared_ptr<const CommandEntry>& command,
+                                const std::string& message)
+    {
+        auto request = Clients::RequestClient::DecodeRequest(message);
+        if (!request.has_value())
+        {
+            Logger->RecordError("Error format request {}", name);
+            return;
+        }
+        auto reply = [this, connection = Connection, id = request->Id, channel = request->ReplyChannel,
+                      command_name = std::string(name)](bool succeeded, const std::string& content){
+            // A failed reply is logged here, otherwise it would be discarded by the dispatcher.
+            try
+            {
+                connection->publish(channel, Clients::RequestClient::EncodeReply(id, succeeded, content));
+            }
+            catch (sw::redis::Error&)
+            {
+                this->RecordCommandException(command_name, std::current_exception());
+            }
+        };
+
+        if (!command || !command->Handler)
+        {
+            Logger->RecordError(command ? "Invalid command handler: {}" : "Unknown command received: {}", name);
+            reply(false, "Unknown command: " + std::string(name));
+            return;
+        }
+        if (!ExecuteCommand(*command, [command, reply, content = std::move(request->Content)]{
+            std::string result;
+            try
+            {
+                result = command->Handler(content);
+            }
+            catch (std::exception& error)
+            {
+                reply(false, error.what());
+                return;
+            }
+            catch (...)
+            {
+                reply(false, "Unknown exception in command " + command->Name + ".");
+                return;
+            }
+            reply(true, result);
+        }))
+        {
+            reply(false, "Command rejected: " + command->Name);
+        }
+    }
+
+    /// Handle a message from the command and request channels of this service.
+    void Service::HandleCommandMessage(const std::string& channel, const std::string& message)
     {
         std::shared_lock lock(CommandHandlersMutex);
-        auto finder = CommandHandlers.find(name);
+        if (auto finder = CommandChannels.find(channel); finder != CommandChannels.end())
+        {
+            auto command = finder->second;
+            lock.unlock();
+            HandleCommand(command, message);
+            return;
+        }
+        if (auto finder = RequestChannels.find(channel); finder != RequestChannels.end())
+        {
+            auto command = finder->second;
+            lock.unlock();
+            HandleRequest(command->Name, command, message);
+            return;
+        }
         lock.unlock();
-        if (finder == CommandHandlers.end())
+
+        // Channels of unknown commands, and the shared channel whose message is the command name.
+        std::string_view channel_view = channel;
+        if (channel_view.size() < 4) return;
+        if (channel_view.size() > Name.size() + 9 &&
+            channel_view.compare(0, Name.size(), Name) == 0 &&
+            channel_view.compare(Name.size(), 9, "/request/") == 0)
         {
-            Logger->RecordError("Unknown command received: " + name);
+            HandleRequest(channel_view.substr(Name.size() + 9), nullptr, message);
             return;
         }
-        if (!finder->second)
+        auto command_slash_index = channel_view.find_last_of('/');
+        if (command_slash_index == std::string_view::npos)
+        {
+            Logger->RecordError("Error format command {}", channel);
+            return;
+        }
+        auto command_name = channel_view.substr(command_slash_index + 1);
+        if (command_name == "command")
+        {
+            static const std::string empty_content;
+            if (auto command = FindCommand(message))
+            {
+                HandleCommand(command, empty_content);
+            }
+        }
+        else if (auto command = FindCommand(command_name))
+        {
+            HandleCommand(command, message);
+        }
+    }
+
+    /// Send a request to a command of a service and get a future of its reply.
+    std::future<Clients::RequestClient::Reply> Service::SendServiceRequest(
+            const std::string& service_name, const std::string& command_name, const std::string& content,
+            std::chrono::milliseconds timeout)
+    {
+        return Requester->SendRequest(service_name, command_name, content, timeout);
+    }
+
+    /// Send a request to a command of a service and invoke the callback with its reply.
+    void Service::SendServiceRequest(const std::string& service_name, const std::string& command_name,
+                                     const std::string& content, std::chrono::milliseconds timeout,
+                                     Clients::RequestClient::ReplyCallback callback)
+    {
+        Requester->SendRequest(service_name, command_name, content, timeout, std::move(callback));
+    }
+
+#ifdef GAIA_FRAMEWORK_COROUTINES
+    /// Send a request to a command of a service and suspend the current task until its reply.
+    Coroutines::CallbackAwaiter<Clients::RequestClient::Reply> Service::SendServiceCommandAsync(
+            std::string service_name, std::string command_name, std::string content,
+            std::chrono::milliseconds timeout)
+    {
+        return {TaskScheduler, [this, service_name = std::move(service_name), command_name = std::move(command_name),
+                                content = std::move(content), timeout](
+                Coroutines::CallbackAwaiter<Clients::RequestClient::Reply>::Callback callback){
+            this->Requester->SendRequest(service_name, command_name, content, timeout, std::move(callback));
+        }};
+    }
+
+    /// Register a coroutine waiting for the next message of a channel.
+    void Service::AddMessageWaiter(MessageAwaiter& awaiter)
+    {
+        std::unique_lock lock(MessageWaitersMutex);
+        if (MessageWaitersClosed)
         {
-            Logger->RecordError("Invalid command handler: " + name);
+            lock.unlock();
+            TaskScheduler.Post(awaiter.Handle);
             return;
         }
-        finder->second(content);
+        MessageWaiters[awaiter.Channel].push_back(&awaiter);
+        bool is_new_channel = AwaitedChannels.insert(awaiter.Channel).second;
+        lock.unlock();
+        if (is_new_channel) DeferSubscription(awaiter.Channel);
+    }
+
+    /// Resume the coroutines waiting for a message.
+    bool Service::DeliverAwaitedMessage(const std::string& channel, const std::string& content)
+    {
+        std::unique_lock lock(MessageWaitersMutex);
+        if (AwaitedChannels.count(channel) == 0) return false;
+        auto finder = MessageWaiters.find(channel);
+        if (finder == MessageWaiters.end()) return true;
+        auto waiters = std::move(finder->second);
+        MessageWaiters.erase(finder);
+        lock.unlock();
+
+        for (auto* waiter : waiters)
+        {
+            // The awaiter may be destroyed as soon as its coroutine is posted.
+            waiter->Message = content;
+            TaskScheduler.Post(waiter->Handle);
+        }
+        return true;
     }
 
+    /// Resume all message waiters with std::nullopt and refuse new ones.
+    void Service::CloseMessageWaiters()
+    {
+        std::unique_lock lock(MessageWaitersMutex);
+        MessageWaitersClosed = true;
+        auto waiters = std::move(MessageWaiters);
+        MessageWaiters.clear();
+        lock.unlock();
+
+        for (auto& [channel, channel_waiters] : waiters)
+        {
+            for (auto* waiter : channel_waiters)
+            {
+                TaskScheduler.Post(waiter->Handle);
+            }
+        }
+    }
+#endif
+
     /// Handle a message.
     void Service::HandleMessage(const std::string &channel, const std::string &content)
     {
+#ifdef GAIA_FRAMEWORK_COROUTINES
+        bool is_awaited = DeliverAwaitedMessage(channel, content);
+#else
+        bool is_awaited = false;
+#endif
         std::shared_lock lock(MessageHandlersMutex);
-        const auto& [begin_iterator, end_iterator] = MessageHandlers.equal_range(channel);
+        auto finder = Subscriptions.find(channel);
+        if (finder == Subscriptions.end())
+        {
+            lock.unlock();
+            if (!is_awaited) Logger->RecordError("Unknown message received: {}", channel);
+            return;
+        }
+        // The entry is shared, so its handlers can be executed after the subscription is removed.
+        auto subscription = finder->second;
         lock.unlock();
-        if (begin_iterator == end_iterator)
+        const auto& handlers = subscription->Handlers;
+
+        if (MessagePool)
+        {
+            std::unique_lock strands_lock(StrandsMutex);
+            auto& strand = MessageStrands[subscription->StrandKey];
+            if (!strand)
+            {
+                strand = std::make_unique<Executors::Strand>(*MessagePool);
+            }
+            strands_lock.unlock();
+            // Handlers of one message run in turn, so the strand keeps the order of messages.
+            strand->Post([this, subscription, content]{
+                for (const auto& handler : subscription->Handlers)
+                {
+                    // A failed handler is logged, and the other handlers still receive the message.
+                    try
+                    {
+                        handler(subscription->Channel, content);
+                    }
+                    catch (std::exception& error)
+                    {
+                        this->Logger->RecordError("Exception in the handler of channel {}: {}",
+                                                  subscription->Channel, error.what());
+                    }
+                    catch (...)
+                    {
+                        this->Logger->RecordError("Unknown exception in the handler of channel {}.",
+                                                  subscription->Channel);
+                    }
+                }
+            });
+            return;
+        }
+
+        if (handlers.size() == 1)
         {
-            Logger->RecordError("Unknown message received: " + channel);
+            handlers.front()(subscription->Channel, content);
             return;
         }
-        tbb::parallel_for_each(begin_iterator, end_iterator,
-                          [&content](const std::pair<std::string, MessageHandler>& pair){
-            if (pair.second) (pair.second)(content);
+        tbb::parallel_for_each(handlers.begin(), handlers.end(),
+                               [&subscription, &content](const SubscriptionHandler& handler){
+            handler(subscription->Channel, content);
+        });
+    }
+
+    /// Handle messages of the given channel in the strand of the given key.
+    void Service::SetSubscriptionStrand(const std::string& channel_name, const std::string& strand_key)
+    {
+        std::unique_lock lock(MessageHandlersMutex);
+        StrandKeys.insert_or_assign(channel_name, strand_key);
+        auto finder = Subscriptions.find(channel_name);
+        if (finder == Subscriptions.end()) return;
+        RebuildSubscription(channel_name, finder->second->Handlers);
+    }
+
+    /// Create the subscriber with all subscribed channels.
+    void Service::CreateSubscriber()
+    {
+        auto subscriber = std::make_shared<sw::redis::Subscriber>(RealtimeConnection->subscriber());
+        subscriber->psubscribe(Name + "/command*");
+        subscriber->psubscribe(Name + "/request/*");
+        subscriber->on_pmessage([this](
+                const std::string& pattern, const std::string& channel, const std::string& message){
+            this->HandleCommandMessage(channel, message);
+            this->FrameScheduler.Notify();
+        });
+        subscriber->on_message([this](const std::string& channel, const std::string& message){
+            // Keyspace notifications are consumed only if their keys are tracked and nobody subscribed them.
+            bool is_consumed = false;
+            if (this->RemoteCache && this->RemoteCache->HandleNotification(channel)) is_consumed = true;
+            if (this->RemoteWatcher && this->RemoteWatcher->HandleNotification(channel)) is_consumed = true;
+            if (is_consumed)
+            {
+                std::shared_lock lock(this->MessageHandlersMutex);
+                if (this->Subscriptions.count(channel) == 0) return;
+            }
+            this->HandleMessage(channel, message);
+            this->FrameScheduler.Notify();
         });
+        subscriber->on_meta([this](sw::redis::Subscriber::MsgType type, sw::redis::OptionalString channel, long long){
+            if (type != sw::redis::Subscriber::MsgType::SUBSCRIBE || !channel.has_value()) return;
+            if (this->RemoteCache) this->RemoteCache->HandleSubscribed(*channel);
+            if (this->RemoteWatcher) this->RemoteWatcher->HandleSubscribed(*channel);
+        });
+        // The subscriber is published under the lock, so subscriptions added meanwhile are not lost.
+        std::shared_lock subscriptions_lock(MessageHandlersMutex);
+        for (const auto& [channel, subscription] : Subscriptions)
+        {
+            subscriber->subscribe(subscription->Channel);
+        }
+        std::atomic_store(&Subscriber, std::move(subscriber));
+    }
+
+    /// Recreate the subscriber with a back-off, and request all deferred channels again.
+    void Service::RecoverSubscriber(const std::atomic_bool& life_flag)
+    {
+        // Keyspace notifications may have been lost, so no cached value can be trusted.
+        if (RemoteCache) RemoteCache->Reset();
+        std::chrono::milliseconds back_off(100);
+        while (true)
+        {
+            if (!life_flag.load()) return;
+            try
+            {
+                CreateSubscriber();
+                break;
+            }
+            catch (sw::redis::Error&)
+            {}
+            // Sleep in slices, so that stopping the service is not delayed by a long back-off.
+            for (std::chrono::milliseconds slept(0); slept < back_off && life_flag.load();
+                 slept += std::chrono::milliseconds(100))
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            }
+            back_off = std::min(back_off * 2, std::chrono::milliseconds(5000));
+        }
+        // Keyspace channels of the cache are subscribed again when their keys are read next time.
+        if (RemoteWatcher)
+        {
+            RemoteWatcher->Resubscribe();
+            RemoteWatcher->Refresh();
+        }
+#ifdef GAIA_FRAMEWORK_COROUTINES
+        std::unique_lock waiters_lock(MessageWaitersMutex);
+        std::vector<std::string> awaited_channels(AwaitedChannels.begin(), AwaitedChannels.end());
+        waiters_lock.unlock();
+        for (const auto& channel : awaited_channels)
+        {
+            DeferSubscription(channel);
+        }
+#endif
     }
 
     void Service::Connect(unsigned int port, const std::string &ip)
@@ -125,34 +682,103 @@ namespace Gaia::Framework
         options.port = static_cast<int>(port);
         options.socket_timeout = std::chrono::milliseconds(1000);
         RealtimeConnection = std::make_shared<sw::redis::Redis>(options);
-        Subscriber = std::make_shared<sw::redis::Subscriber>(RealtimeConnection->subscriber());
-        Subscriber->psubscribe(Name + "/command*");
-        Subscriber->on_pmessage([this](
-                const std::string& pattern, const std::string& channel, const std::string& message){
-            if (channel.size() < 4) return;
-            auto command_slash_index = channel.find_last_of('/');
-            if (command_slash_index == std::string::npos)
-            {
-                this->Logger->RecordError("Error format command " + channel);
-                return;
-            }
-            auto command_name = channel.substr(command_slash_index + 1);
-            if (command_name == "command")
+        CreateSubscriber();
+        Logger = std::make_unique<Clients::LogClient>(Name, Connection);
+        Requester = std::make_unique<Clients::RequestClient>(Name, Connection);
+        AddSubscription(Requester->GetReplyChannel(), [this](const std::string& content){
+            this->Requester->HandleReply(content);
+        });
+        if (OptionVariables.count("log-async"))
+        {
+            Logger->EnableAsyncMode();
+        }
+        if (OptionVariables.count("log-segments"))
+        {
+            Logger->EnableOfflineSegments(OptionVariables["log-segments"].as<std::string>());
+        }
+        if (OptionVariables.count("log-rotate-size") || OptionVariables.count("log-rotate-period") ||
+            OptionVariables.count("log-retention"))
+        {
+            Clients::LogRecorder::RotationOptions rotation;
+            if (OptionVariables.count("log-rotate-size"))
+                rotation.MaxFileSize = OptionVariables["log-rotate-size"].as<unsigned int>() * 1024ULL * 1024ULL;
+            if (OptionVariables.count("log-rotate-period"))
+                rotation.Period = std::chrono::seconds(OptionVariables["log-rotate-period"].as<unsigned int>());
+            if (OptionVariables.count("log-retention"))
+                rotation.RetentionBytes = OptionVariables["log-retention"].as<unsigned int>() * 1024ULL * 1024ULL;
+            Logger->EnableOfflineRotation(rotation);
+        }
+        if (OptionVariables.count("log-throttle"))
+        {
+            Clients::LogThrottle::Options throttle;
+            throttle.Rate = OptionVariables["log-throttle"].as<double>();
+            throttle.Burst = std::max(throttle.Rate * 2.0, 1.0);
+            Logger->EnableThrottle(throttle);
+        }
+        if (OptionVariables.count("log-spill"))
+        {
+            Logger->EnableSpillRecovery(OptionVariables["log-spill"].as<std::string>());
+        }
+        if (OptionVariables.count("log-level"))
+        {
+            auto severity = Clients::LogFormatter::ParseSeverity(OptionVariables["log-level"].as<std::string>());
+            if (severity.has_value())
             {
-                this->HandleCommand(message, std::string());
+                Logger->SetMinimumSeverity(*severity);
             }
             else
             {
-                this->HandleCommand(command_name, message);
+                Logger->RecordWarning("Invalid log level option: {}", OptionVariables["log-level"].as<std::string>());
             }
-        });
-        Subscriber->on_message([this](const std::string& channel, const std::string& message){
-            this->HandleMessage(channel, message);
-        });
-        Logger = std::make_unique<Clients::LogClient>(Name, Connection);
+        }
         Configurator = std::make_unique<Clients::ConfigurationClient>(Name, Connection);
+        if (OptionVariables.count("configuration-cache"))
+        {
+            Configurator->EnableCache();
+            AddSubscription(Clients::ConfigurationClient::LoadChannel, [this](const std::string& content){
+                this->Configurator->HandleNotification(Clients::ConfigurationClient::LoadChannel, content);
+            });
+            AddSubscription(Clients::ConfigurationClient::UpdateChannel, [this](const std::string& content){
+                this->Configurator->HandleNotification(Clients::ConfigurationClient::UpdateChannel, content);
+            });
+        }
         NameResolver = std::make_unique<Clients::NameClient>(Connection);
+        if (OptionVariables.count("name-registry"))
+        {
+            NameResolver->EnableRegistry();
+        }
+        if (OptionVariables.count("name-cache"))
+        {
+            NameResolver->EnableResolverCache(
+                    std::chrono::milliseconds(OptionVariables["name-cache"].as<unsigned int>()));
+        }
+        if (OptionVariables.count("name-registry") || OptionVariables.count("name-cache"))
+        {
+            AddSubscription(Clients::NameClient::EventsChannel, [this](const std::string& content){
+                this->NameResolver->HandleEvent(content);
+            });
+        }
+        RemoteFlusher = std::make_unique<Clients::RemoteValueFlusher>(Connection);
+        RemoteWatcher = std::make_unique<Clients::RemoteValueWatcher>(Connection, [this](const std::string& channel){
+            this->DeferSubscription(channel);
+        });
+        if (OptionVariables.count("remote-cache") && OptionVariables["remote-cache"].as<unsigned int>() > 0)
+        {
+            EnableRemoteValueCache(OptionVariables["remote-cache"].as<unsigned int>());
+        }
         NameResolver->RegisterName(Name);
+        std::chrono::milliseconds heartbeat_interval(1000);
+        double heartbeat_ttl_ratio = 3.0;
+        if (OptionVariables.count("name-heartbeat-interval"))
+        {
+            heartbeat_interval = std::chrono::milliseconds(
+                    OptionVariables["name-heartbeat-interval"].as<unsigned int>());
+        }
+        if (OptionVariables.count("name-ttl-ratio"))
+        {
+            heartbeat_ttl_ratio = OptionVariables["name-ttl-ratio"].as<double>();
+        }
+        NameResolver->StartHeartbeat(heartbeat_interval, heartbeat_ttl_ratio);
         OnConnect();
     }
 
@@ -162,34 +788,176 @@ namespace Gaia::Framework
         Connection->publish(service_name + "/command/" + command_name, content);
     }
 
+    /// Register a command and intern its channels.
+    void Service::RegisterCommand(const std::string& name, CommandHandler handler)
+    {
+        auto command = std::make_shared<CommandEntry>();
+        command->Name = name;
+        command->CommandChannel = Name + "/command/" + name;
+        command->RequestChannel = Name + "/request/" + name;
+        command->Handler = std::move(handler);
+
+        std::unique_lock lock(CommandHandlersMutex);
+        command->IsControlCommand = ControlCommands.count(name) > 0;
+        if (!CommandEntries.emplace(command->Name, command).second) return;
+        CommandChannels.emplace(command->CommandChannel, command);
+        RequestChannels.emplace(command->RequestChannel, command);
+    }
+
     /// Add a command handler.
     void Service::AddCommand(const std::string& name, Service::MessageHandler handler)
     {
-        std::unique_lock lock(CommandHandlersMutex);
-        CommandHandlers.emplace(name, handler);
+        if (!handler)
+        {
+            RegisterCommand(name, nullptr);
+            return;
+        }
+        RegisterCommand(name, [handler = std::move(handler)](const std::string& content){
+            handler(content);
+            return std::string();
+        });
     }
 
     /// Remove a command handler.
     void Service::RemoveCommand(const std::string &name)
     {
         std::unique_lock lock(CommandHandlersMutex);
-        CommandHandlers.erase(name);
+        auto finder = CommandEntries.find(name);
+        if (finder == CommandEntries.end()) return;
+        // Keys are views into the entry, which is kept alive until all of them are erased.
+        auto command = finder->second;
+        CommandChannels.erase(command->CommandChannel);
+        RequestChannels.erase(command->RequestChannel);
+        CommandEntries.erase(finder);
+    }
+
+    /// Replace the subscription entry of a channel with the given handlers.
+    void Service::RebuildSubscription(const std::string& channel_name, std::vector<SubscriptionHandler> handlers)
+    {
+        auto subscription = std::make_shared<SubscriptionEntry>();
+        subscription->Channel = channel_name;
+        auto strand_finder = StrandKeys.find(channel_name);
+        subscription->StrandKey = strand_finder != StrandKeys.end() ? strand_finder->second : channel_name;
+        subscription->Handlers = std::move(handlers);
+
+        // The key of the previous entry is a view into it, so it is erased before the entry is replaced.
+        Subscriptions.erase(channel_name);
+        std::string_view key = subscription->Channel;
+        Subscriptions.emplace(key, std::move(subscription));
+    }
+
+    /// Add a handler to the subscription of a channel.
+    void Service::RegisterSubscription(const std::string& channel_name, SubscriptionHandler handler)
+    {
+        std::unique_lock lock(MessageHandlersMutex);
+        std::vector<SubscriptionHandler> handlers;
+        if (auto finder = Subscriptions.find(channel_name); finder != Subscriptions.end())
+        {
+            handlers = finder->second->Handlers;
+        }
+        if (handler) handlers.push_back(std::move(handler));
+        RebuildSubscription(channel_name, std::move(handlers));
+        lock.unlock();
+
+        // Subscriptions added before the connection are subscribed by Connect().
+        if (auto subscriber = std::atomic_load(&Subscriber)) subscriber->subscribe(channel_name);
     }
 
     /// Add a subscription to the given channel.
     void Service::AddSubscription(const std::string &channel_name, const Service::MessageHandler& handler)
     {
-        std::unique_lock lock(MessageHandlersMutex);
-        MessageHandlers.emplace(std::make_pair(channel_name, handler));
-        Subscriber->subscribe(channel_name);
+        if (!handler)
+        {
+            RegisterSubscription(channel_name, nullptr);
+            return;
+        }
+        RegisterSubscription(channel_name, [handler](const std::string&, const std::string& content){
+            handler(content);
+        });
+    }
+
+    /// Add a subscription whose handler receives views of the channel name and the content.
+    void Service::AddSubscription(const std::string& channel_name, ChannelMessageHandler handler)
+    {
+        if (!handler)
+        {
+            RegisterSubscription(channel_name, nullptr);
+            return;
+        }
+        RegisterSubscription(channel_name, [handler = std::move(handler)](
+                const std::string& channel, const std::string& content){
+            handler(channel, content);
+        });
+    }
+
+    /// Subscribe a channel on the message thread.
+    void Service::DeferSubscription(const std::string& channel_name)
+    {
+        std::unique_lock lock(PendingSubscriptionsMutex);
+        PendingSubscriptions.push_back(channel_name);
     }
 
     /// Remove all subscriptions to the given channel.
     void Service::RemoveSubscription(const std::string &channel_name)
     {
-        Subscriber->unsubscribe(channel_name);
+        if (auto subscriber = std::atomic_load(&Subscriber)) subscriber->unsubscribe(channel_name);
         std::unique_lock lock(MessageHandlersMutex);
-        MessageHandlers.erase(channel_name);
+        Subscriptions.erase(channel_name);
+    }
+
+    /// Get the batch of the multi-key remote value methods.
+    Clients::RemoteBatch& Service::AcquireRemoteValuesBatch()
+    {
+        if (!RemoteValuesBatch)
+        {
+            RemoteValuesBatch = std::make_unique<Clients::RemoteBatch>(Connection);
+        }
+        return *RemoteValuesBatch;
+    }
+
+    /// Check whether remote values exist or not, in one pipeline.
+    std::vector<bool> Service::HasRemoteValues(const std::vector<std::string>& names)
+    {
+        std::vector<bool> existences(names.size(), false);
+        if (!Connection || names.empty()) return existences;
+
+        std::unique_lock lock(RemoteValuesMutex);
+        auto& batch = AcquireRemoteValuesBatch();
+        std::vector<Clients::RemoteBatch::Reply<bool>> replies;
+        replies.reserve(names.size());
+        for (const auto& name : names)
+        {
+            replies.push_back(batch.Has(name));
+        }
+        batch.Execute();
+        for (std::size_t index = 0; index < replies.size(); ++index)
+        {
+            existences[index] = replies[index].Get().value_or(false);
+        }
+        return existences;
+    }
+
+    /// Cache remote values read by GetRemoteValue() in this process.
+    void Service::EnableRemoteValueCache(std::size_t capacity)
+    {
+        if (!Connection || RemoteCache) return;
+        // Reads may happen on any thread, so keyspace channels are subscribed by the message thread.
+        RemoteCache = std::make_unique<Clients::RemoteValueCache>(
+                Connection, [this](const std::string& channel){
+                    this->DeferSubscription(channel);
+                }, capacity);
+        CheckKeyspaceNotifications();
+    }
+
+    /// Log a warning if the server does not publish keyspace notifications.
+    void Service::CheckKeyspaceNotifications()
+    {
+        if (KeyspaceNotificationsChecked.exchange(true)) return;
+        if (!Clients::RemoteValueCache::CheckNotifications(*Connection))
+        {
+            Logger->RecordWarning("Keyspace notifications are not enabled, cached and watched remote values "
+                                  "may be stale. Configure the Redis server with \"notify-keyspace-events Kg$x\".");
+        }
     }
 
     /// Pause this service.
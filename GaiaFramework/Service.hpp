@@ -2,19 +2,44 @@
 
 #include "Clients/LogClient.hpp"
 #include "Clients/ConfigurationClient.hpp"
+#include "Clients/ConfigurationProfile.hpp"
 #include "Clients/NameClient.hpp"
+#include "Clients/RequestClient.hpp"
+#include "Clients/RemoteBatch.hpp"
+#include "Clients/RemoteValueCache.hpp"
+#include "Clients/RemoteValue.hpp"
+#include "Clients/RemoteValueWatcher.hpp"
+#include "Executors/CommandDispatcher.hpp"
+#include "Executors/Strand.hpp"
+#include "Executors/UpdateScheduler.hpp"
+#include "Codecs/BinaryCodec.hpp"
+#include "Codecs/TextCodec.hpp"
+#ifdef GAIA_FRAMEWORK_COROUTINES
+#include "Coroutines/Task.hpp"
+#include "Coroutines/Scheduler.hpp"
+#include "Coroutines/CallbackAwaiter.hpp"
+#endif
 #include <sw/redis++/redis++.h>
 #include <string>
+#include <string_view>
+#include <memory>
 #include <chrono>
 #include <functional>
+#include <stdexcept>
 #include <optional>
 #include <list>
+#include <vector>
+#include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <shared_mutex>
 #include <atomic>
+#include <future>
+#include <type_traits>
+#include <iterator>
+#include <utility>
 #include <GaiaBackground/GaiaBackground.hpp>
 #include <boost/program_options.hpp>
-#include <boost/lexical_cast.hpp>
 
 namespace Gaia::Framework
 {
@@ -25,23 +50,92 @@ namespace Gaia::Framework
 
     public:
         using MessageHandler = std::function<void(const std::string&)>;
+        /// Handler of a command, returns the content of the reply to a request.
+        using CommandHandler = std::function<std::string(const std::string&)>;
+        /// Handler of messages which receives views of the channel name and the content.
+        using ChannelMessageHandler = std::function<void(std::string_view, std::string_view)>;
 
     private:
+        /// Handler of a subscription, receives the channel name and the content.
+        using SubscriptionHandler = std::function<void(const std::string&, const std::string&)>;
+
+        /// Command with its channels interned, immutable once it is registered.
+        struct CommandEntry
+        {
+            std::string Name;
+            /// Channel "<service>/command/<name>".
+            std::string CommandChannel;
+            /// Channel "<service>/request/<name>".
+            std::string RequestChannel;
+            /// Handler of the command, null if the handler is invalid.
+            CommandHandler Handler;
+            /// Control commands are always handled on the message thread.
+            bool IsControlCommand {false};
+        };
+        /// Subscription of a channel, replaced as a whole when it is modified.
+        struct SubscriptionEntry
+        {
+            std::string Channel;
+            /// Key of the strand which handles messages of this channel.
+            std::string StrandKey;
+            std::vector<SubscriptionHandler> Handlers;
+        };
+
         /// Mutex for commands map.
         std::shared_mutex CommandHandlersMutex;
-        /// Command handlers map.
-        std::unordered_map<std::string, MessageHandler> CommandHandlers;
+        /// Commands by their names, keys are views of the names in entries.
+        std::unordered_map<std::string_view, std::shared_ptr<const CommandEntry>> CommandEntries;
+        /// Commands by their full command channels, keys are views of the channels in entries.
+        std::unordered_map<std::string_view, std::shared_ptr<const CommandEntry>> CommandChannels;
+        /// Commands by their full request channels, keys are views of the channels in entries.
+        std::unordered_map<std::string_view, std::shared_ptr<const CommandEntry>> RequestChannels;
+        /// Control commands, which are always handled on the message thread.
+        std::unordered_set<std::string> ControlCommands;
+        /// Dispatcher which executes other commands on a thread pool.
+        Executors::CommandDispatcher Dispatcher;
         /// Mutex for messages map.
         std::shared_mutex MessageHandlersMutex;
-        /// Message handlers map.
-        std::unordered_multimap<std::string, MessageHandler> MessageHandlers;
-        /// Handle a command.
-        void HandleCommand(const std::string& name, const std::string& content);
-        /// Handle a message.
+        /// Subscriptions by their channels, keys are views of the channels in entries.
+        std::unordered_map<std::string_view, std::shared_ptr<const SubscriptionEntry>> Subscriptions;
+        /// Maps channels to the keys of their strands, channels not in it use their own names as keys.
+        std::unordered_map<std::string, std::string> StrandKeys;
+        /// Pool to execute message handlers in strands, null if messages are handled on the message thread.
+        std::unique_ptr<Executors::ThreadPool> MessagePool;
+        /// Mutex for strands.
+        std::mutex StrandsMutex;
+        /// Strands of messages, messages of the same strand are handled in their arrival order.
+        std::unordered_map<std::string, std::unique_ptr<Executors::Strand>> MessageStrands;
+        /// Register a command and intern its channels, ignored if a command with the same name exists.
+        void RegisterCommand(const std::string& name, CommandHandler handler);
+        /// Add a handler to the subscription of a channel, and subscribe the channel if it is new.
+        void RegisterSubscription(const std::string& channel_name, SubscriptionHandler handler);
+        /// Replace the subscription entry of a channel with the given handlers, the messages mutex must be held.
+        void RebuildSubscription(const std::string& channel_name, std::vector<SubscriptionHandler> handlers);
+        /// Find the command of the given name, logs an error and returns null if it is unknown or invalid.
+        std::shared_ptr<const CommandEntry> FindCommand(std::string_view name);
+        /// Execute a command inline or on the dispatcher, returns false if the dispatcher rejected it.
+        bool ExecuteCommand(const CommandEntry& command, std::function<void()> execution);
+        /// Handle a command, it is executed inline without copies when it is not dispatched.
+        void HandleCommand(const std::shared_ptr<const CommandEntry>& command, const std::string& content);
+        /// Log an exception thrown by a command, or by the publishing of its reply.
+        void RecordCommandException(const std::string& name, std::exception_ptr exception);
+        /// Handle a request to a command, and publish the reply, the command is null if it is unknown.
+        void HandleRequest(std::string_view name, const std::shared_ptr<const CommandEntry>& command,
+                           const std::string& message);
+
+    protected:
+        /**
+         * @brief Handle a message from the command and request channels of this service.
+         * @details
+         *  Known command channels are found in one lookup of the full channel name,
+         *  and handlers executed on the message thread receive the content without copies.
+         *  Invoked on the message thread, derived classes can also inject messages with it.
+         */
+        void HandleCommandMessage(const std::string& channel, const std::string& message);
+        /// Handle a message from a subscribed channel, invoked on the message thread.
         void HandleMessage(const std::string& channel, const std::string& content);
 
-        /// Time point of last name service update.
-        std::chrono::system_clock::time_point LastHeartBeatTime;
+    private:
 
         /**
          * @brief Enable of this service.
@@ -53,6 +147,74 @@ namespace Gaia::Framework
 
         /// Updater for message pulling loop.
         Gaia::Background::BackgroundWorker MessageUpdater;
+        /// Paces the frames of the main loop, woken by messages in event-driven mode.
+        Executors::UpdateScheduler FrameScheduler;
+        /// Mutex for pending subscriptions.
+        std::mutex PendingSubscriptionsMutex;
+        /// Channels to subscribe on the message thread before it consumes messages again.
+        std::vector<std::string> PendingSubscriptions;
+        /// Subscribe a channel on the message thread, used by threads which can not access the subscriber.
+        void DeferSubscription(const std::string& channel_name);
+        /// Create the subscriber, subscribe the command patterns and install the message callbacks.
+        void CreateSubscriber();
+        /**
+         * @brief Recreate the subscriber after a connection error, with all its channels.
+         * @details
+         *  Runs on the message thread and retries with an exponential back-off until it succeeds
+         *  or the life flag becomes false. Watched keys are read again once after it succeeds.
+         */
+        void RecoverSubscriber(const std::atomic_bool& life_flag);
+
+#ifdef GAIA_FRAMEWORK_COROUTINES
+    public:
+        /// Awaiter which resumes the coroutine with the next message of a channel.
+        class MessageAwaiter
+        {
+            friend class Service;
+
+        private:
+            Service& Owner;
+            std::string Channel;
+            std::optional<std::string> Message;
+            std::coroutine_handle<> Handle;
+
+        public:
+            MessageAwaiter(Service& owner, std::string channel) : Owner(owner), Channel(std::move(channel))
+            {}
+
+            [[nodiscard]] bool await_ready() const noexcept
+            {
+                return false;
+            }
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                Handle = handle;
+                Owner.AddMessageWaiter(*this);
+            }
+            std::optional<std::string> await_resume()
+            {
+                return std::move(Message);
+            }
+        };
+
+    private:
+        /// Scheduler of coroutine tasks, run in every frame before OnUpdate().
+        Coroutines::Scheduler TaskScheduler;
+        /// Mutex for message waiters and awaited channels.
+        std::mutex MessageWaitersMutex;
+        /// Coroutines waiting for the next message of channels.
+        std::unordered_map<std::string, std::vector<MessageAwaiter*>> MessageWaiters;
+        /// Channels subscribed for message waiters.
+        std::unordered_set<std::string> AwaitedChannels;
+        /// Whether new message waiters are resumed at once with std::nullopt, true when uninstalled.
+        bool MessageWaitersClosed {false};
+        /// Register a coroutine waiting for the next message of a channel.
+        void AddMessageWaiter(MessageAwaiter& awaiter);
+        /// Resume the coroutines waiting for a message, returns whether the channel is awaited or not.
+        bool DeliverAwaitedMessage(const std::string& channel, const std::string& content);
+        /// Resume all message waiters with std::nullopt and refuse new ones.
+        void CloseMessageWaiters();
+#endif
 
     private:
         /// Connection to the Redis server.
@@ -67,6 +229,24 @@ namespace Gaia::Framework
         std::unique_ptr<Clients::ConfigurationClient> Configurator {nullptr};
         /// Name service client.
         std::unique_ptr<Clients::NameClient> NameResolver {nullptr};
+        /// Client to send requests to other services.
+        std::unique_ptr<Clients::RequestClient> Requester {nullptr};
+        /// Mutex for the batch of remote values.
+        std::mutex RemoteValuesMutex;
+        /// Batch used by the multi-key remote value methods, created on first use.
+        std::unique_ptr<Clients::RemoteBatch> RemoteValuesBatch {nullptr};
+        /// Get the batch of the multi-key remote value methods, RemoteValuesMutex must be held.
+        Clients::RemoteBatch& AcquireRemoteValuesBatch();
+        /// Cache of remote values read by GetRemoteValue(), null if it is not enabled.
+        std::unique_ptr<Clients::RemoteValueCache> RemoteCache {nullptr};
+        /// Background writer of remote value handles.
+        std::unique_ptr<Clients::RemoteValueFlusher> RemoteFlusher {nullptr};
+        /// Notifies handlers of changes of watched remote values.
+        std::unique_ptr<Clients::RemoteValueWatcher> RemoteWatcher {nullptr};
+        /// Whether the keyspace notification configuration of the server has been checked or not.
+        std::atomic_bool KeyspaceNotificationsChecked {false};
+        /// Log a warning if the server does not publish keyspace notifications, checked only once.
+        void CheckKeyspaceNotifications();
 
     protected:
         /**
@@ -77,10 +257,22 @@ namespace Gaia::Framework
          */
         void SendServiceCommand(const std::string& service_name, const std::string& command_name,
                                 const std::string& content = "");
+        /**
+         * @brief Send a command whose content is a value encoded in the binary format.
+         * @tparam ValueType Type of the value, see Codecs::IsBinaryEncodable.
+         * @details The target command should be added by AddCommand<ValueType>(...).
+         */
+        template <typename ValueType, typename = std::enable_if_t<
+                Codecs::IsBinaryEncodable<ValueType> && !std::is_constructible_v<std::string, const ValueType&>>>
+        void SendServiceCommand(const std::string& service_name, const std::string& command_name,
+                                const ValueType& value)
+        {
+            SendServiceCommand(service_name, command_name, Codecs::EncodeBinary(value));
+        }
 
         /**
          * @brief Set the value of the given value.
-         * @tparam ValueType Type of the value to set.
+         * @tparam ValueType Type of the value to set, converted to text by Codecs::TextCodec.
          * @param name Name of the value.
          * @param value Value to set.
          */
@@ -89,7 +281,8 @@ namespace Gaia::Framework
         {
             if (Connection)
             {
-                Connection->set(name, std::to_string(value));
+                Connection->set(name, Codecs::EncodeText(value));
+                if (RemoteCache) RemoteCache->Invalidate(name);
             }
         }
 
@@ -105,7 +298,8 @@ namespace Gaia::Framework
         {
             if (Connection)
             {
-                Connection->set(name, std::to_string(value), lasting_seconds);
+                Connection->set(name, Codecs::EncodeText(value), lasting_seconds);
+                if (RemoteCache) RemoteCache->Invalidate(name);
             }
         }
 
@@ -123,41 +317,351 @@ namespace Gaia::Framework
 
         /**
          * @brief Get the value of a remote value.
-         * @tparam ValueType Type of the value.
+         * @tparam ValueType Type of the value, parsed by Codecs::TextCodec.
          * @param name Name of the value.
          * @return std::nullopt, if the desired value does not exist or fail to be converted into the given type;
          *         otherwise std::optional that contains the value in the desired type.
+         * @details Values are read from memory when the remote value cache is enabled and they are cached.
          */
         template <typename ValueType>
         std::optional<ValueType> GetRemoteValue(const std::string& name)
         {
             if (Connection)
             {
-                auto optional_text = Connection->get(name);
-                if (optional_text.has_value())
-                    try{
-                        return {boost::lexical_cast<ValueType>(optional_text.value())};
-                    }catch (boost::bad_lexical_cast& error){}
+                auto optional_text = RemoteCache ? RemoteCache->Get(name) : Connection->get(name);
+                if (optional_text.has_value()) return Codecs::DecodeText<ValueType>(*optional_text);
             }
             return std::nullopt;
         }
 
+        /**
+         * @brief Create a batch of remote value operations which are sent in one round trip.
+         * @details The batch owns a pipeline connection, keep it to reuse for repeated rounds.
+         */
+        [[nodiscard]] Clients::RemoteBatch CreateRemoteBatch() const
+        {
+            return Clients::RemoteBatch(Connection);
+        }
+
+        /**
+         * @brief Set remote values with one MSET.
+         * @tparam ValueType Type of the values, converted to text by Codecs::TextCodec.
+         * @param values Pairs of names and values.
+         */
+        template <typename ValueType>
+        void SetRemoteValues(const std::vector<std::pair<std::string, ValueType>>& values)
+        {
+            if (!Connection || values.empty()) return;
+            std::vector<std::pair<std::string, std::string>> texts;
+            texts.reserve(values.size());
+            for (const auto& [name, value] : values)
+            {
+                texts.emplace_back(name, Codecs::EncodeText(value));
+            }
+            Connection->mset(texts.begin(), texts.end());
+            if (RemoteCache)
+            {
+                for (const auto& [name, value] : values) RemoteCache->Invalidate(name);
+            }
+        }
+
+        /**
+         * @brief Set remote values which expire after the given time, in one pipeline.
+         * @tparam ValueType Type of the values, converted to text by Codecs::TextCodec.
+         * @param values Pairs of names and values.
+         * @param time_to_live Every value expires after this time.
+         */
+        template <typename ValueType>
+        void SetRemoteValues(const std::vector<std::pair<std::string, ValueType>>& values,
+                             std::chrono::milliseconds time_to_live)
+        {
+            if (!Connection || values.empty()) return;
+            std::unique_lock lock(RemoteValuesMutex);
+            auto& batch = AcquireRemoteValuesBatch();
+            for (const auto& [name, value] : values)
+            {
+                batch.Set(name, value, time_to_live);
+            }
+            batch.Execute();
+            lock.unlock();
+            if (RemoteCache)
+            {
+                for (const auto& [name, value] : values) RemoteCache->Invalidate(name);
+            }
+        }
+
+        /**
+         * @brief Get remote values with one MGET.
+         * @tparam ValueType Type of the values, parsed by Codecs::TextCodec.
+         * @param names Names of the values.
+         * @return Values in the order of the names, std::nullopt for values which do not exist or can not be parsed.
+         */
+        template <typename ValueType>
+        std::vector<std::optional<ValueType>> GetRemoteValues(const std::vector<std::string>& names)
+        {
+            std::vector<std::optional<ValueType>> values;
+            if (!Connection || names.empty())
+            {
+                values.resize(names.size());
+                return values;
+            }
+            std::vector<sw::redis::OptionalString> texts;
+            texts.reserve(names.size());
+            Connection->mget(names.begin(), names.end(), std::back_inserter(texts));
+            values.reserve(texts.size());
+            for (const auto& text : texts)
+            {
+                values.push_back(text.has_value() ? Codecs::DecodeText<ValueType>(*text) : std::nullopt);
+            }
+            return values;
+        }
+
+        /**
+         * @brief Check whether remote values exist or not, in one pipeline.
+         * @return Existences in the order of the names.
+         */
+        std::vector<bool> HasRemoteValues(const std::vector<std::string>& names);
+
+        /**
+         * @brief Cache remote values read by GetRemoteValue() in this process.
+         * @param capacity Maximum count of cached keys, other keys are read from the server every time.
+         * @details
+         *  Cached values are invalidated by keyspace notifications when any client modifies them,
+         *  which requires the server to be configured with "notify-keyspace-events Kg$x" or "KA";
+         *  a warning is logged if it is not. Values written by this service are invalidated at once.
+         *  It is enabled by the "remote-cache" option, and should be enabled before the service is installed.
+         */
+        void EnableRemoteValueCache(std::size_t capacity = 4096);
+        /**
+         * @brief Create a handle which writes a remote value at a limited rate.
+         * @tparam ValueType Type of the value, converted to text by Codecs::TextCodec.
+         * @param name Name of the value.
+         * @param options Interval, threshold and time to live of the value.
+         * @return The handle, empty if the service is not connected.
+         * @details
+         *  Producers which update a value more frequently than it is read should use a handle instead of
+         *  SetRemoteValue(): only the latest value is written, and all handles of this service are written
+         *  together in one pipeline by a background thread. Buffered values are written when uninstalled.
+         *  Handles must be destroyed before the service.
+         */
+        template <typename ValueType>
+        Clients::RemoteValue<ValueType> CreateRemoteValue(
+                const std::string& name, const Clients::RemoteValueFlusher::Options& options = {})
+        {
+            if (!RemoteFlusher) return {};
+            RemoteFlusher->Start();
+            return Clients::RemoteValue<ValueType>(RemoteFlusher->CreateSlot(name, options));
+        }
+        /// Get the statistics of the writer of remote value handles.
+        [[nodiscard]] Clients::RemoteValueFlusher::FlushStatistics GetRemoteFlushStatistics() const
+        {
+            return RemoteFlusher ? RemoteFlusher->GetStatistics() : Clients::RemoteValueFlusher::FlushStatistics{};
+        }
+
+        /**
+         * @brief Watch changes of a remote value instead of polling it.
+         * @tparam ValueType Type of the value, parsed by Codecs::TextCodec.
+         * @param name Name of the value.
+         * @param handler Receives the latest value, or std::nullopt if the value does not exist
+         *                or can not be parsed.
+         * @details
+         *  Changes are notified by keyspace notifications through the subscriber of this service,
+         *  which requires the server to be configured with "notify-keyspace-events Kg$x" or "KA".
+         *  The handler receives the current value once the watch is established, and the latest value after
+         *  changes, on a background thread; changes made while the handler is running are coalesced,
+         *  so intermediate values may be skipped.
+         */
+        template <typename ValueType>
+        void WatchRemoteValue(const std::string& name, std::function<void(const std::optional<ValueType>&)> handler)
+        {
+            if (!RemoteWatcher || !handler) return;
+            CheckKeyspaceNotifications();
+            RemoteWatcher->Start();
+            RemoteWatcher->Watch(name, [this, name, handler = std::move(handler)](
+                    const std::optional<std::string>& text){
+                std::optional<ValueType> value;
+                if (text.has_value()) value = Codecs::DecodeText<ValueType>(*text);
+                try
+                {
+                    handler(value);
+                }
+                catch (std::exception& error)
+                {
+                    this->Logger->RecordError("Exception in the watcher of remote value {}: {}", name, error.what());
+                }
+            });
+        }
+        /// Remove all watchers of a remote value.
+        void UnwatchRemoteValue(const std::string& name)
+        {
+            if (RemoteWatcher) RemoteWatcher->Unwatch(name);
+        }
+        /// Get the statistics of watchers of remote values.
+        [[nodiscard]] Clients::RemoteValueWatcher::WatchStatistics GetRemoteWatchStatistics() const
+        {
+            return RemoteWatcher ? RemoteWatcher->GetStatistics() : Clients::RemoteValueWatcher::WatchStatistics{};
+        }
+
+        /// Get the remote value cache of this service, null if it is not enabled.
+        [[nodiscard]] inline Clients::RemoteValueCache* GetRemoteValueCache() const noexcept
+        {
+            return RemoteCache.get();
+        }
+
+        /**
+         * @brief Send a request to a command of a service and get a future of its reply.
+         * @param service_name Name of the target service.
+         * @param command_name Name of the service command.
+         * @param content Content for the command request.
+         * @param timeout The reply is of ReplyStatus::TimedOut if it does not arrive in this time.
+         * @return Future of the reply, which tells whether the command succeeded, failed or timed out.
+         * @attention Replies are handled like messages of the reply channel, on the message thread or on the strand
+         *            of the reply channel, waiting for them on that thread will always time out.
+         */
+        std::future<Clients::RequestClient::Reply> SendServiceRequest(
+                const std::string& service_name, const std::string& command_name, const std::string& content = "",
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+        /**
+         * @brief Send a request to a command of a service and invoke the callback with its reply.
+         * @param callback Receives the reply, which tells whether the command succeeded, failed or timed out.
+         */
+        void SendServiceRequest(const std::string& service_name, const std::string& command_name,
+                                const std::string& content, std::chrono::milliseconds timeout,
+                                Clients::RequestClient::ReplyCallback callback);
+
         /**
          * @brief Add a command handler to support a command.
          * @param name Name of the command.
          * @param handler Handler functor.
+         * @details Requests to this command receive an empty reply when the handler returns.
          */
         void AddCommand(const std::string& name, MessageHandler handler);
+        /**
+         * @brief Add a command handler.
+         * @param name Name of the command.
+         * @param handler Handler functor which receives the content as a std::string or a std::string_view,
+         *                and returns nothing or the content of the reply.
+         * @details
+         *  Requests to a command whose handler returns nothing receive an empty reply.
+         *  The returned content is discarded when the command is sent without a request.
+         */
+        template <typename HandlerType,
+                  typename ResultType = std::invoke_result_t<HandlerType&, const std::string&>,
+                  typename = std::enable_if_t<std::is_void_v<ResultType> ||
+                                              std::is_convertible_v<ResultType, std::string>>>
+        void AddCommand(const std::string& name, HandlerType handler)
+        {
+            if constexpr (std::is_void_v<ResultType>)
+            {
+                RegisterCommand(name, [handler = std::move(handler)](const std::string& content) mutable{
+                    handler(content);
+                    return std::string();
+                });
+            }
+            else
+            {
+                RegisterCommand(name, CommandHandler(std::move(handler)));
+            }
+        }
+
+        /**
+         * @brief Add a command whose content is a value encoded in the binary format.
+         * @tparam ValueType Type of the value, see Codecs::IsBinaryEncodable.
+         * @param name Name of the command.
+         * @param handler Handler functor which receives the decoded value, and returns nothing,
+         *                a std::string as the raw reply content, or a value encoded as the reply content.
+         * @details
+         *  The value is decoded directly from the received content.
+         *  Contents in other formats or schema versions are rejected with a std::invalid_argument,
+         *  so requests receive an error reply, and commands without requests are logged as errors.
+         */
+        template <typename ValueType, typename HandlerType,
+                  typename = std::enable_if_t<Codecs::IsBinaryEncodable<ValueType> &&
+                                              !std::is_constructible_v<std::string, const ValueType&> &&
+                                              std::is_invocable_v<HandlerType&, const ValueType&>>>
+        void AddCommand(const std::string& name, HandlerType handler)
+        {
+            RegisterCommand(name, [name, handler = std::move(handler)](const std::string& content) mutable{
+                ValueType value {};
+                if (!Codecs::DecodeBinary(content, value))
+                {
+                    throw std::invalid_argument("Invalid binary content of command " + name + ".");
+                }
+                using ResultType = std::invoke_result_t<HandlerType&, const ValueType&>;
+                if constexpr (std::is_void_v<ResultType>)
+                {
+                    handler(value);
+                    return std::string();
+                }
+                else if constexpr (std::is_convertible_v<ResultType, std::string>)
+                {
+                    return std::string(handler(value));
+                }
+                else
+                {
+                    return Codecs::EncodeBinary(handler(value));
+                }
+            });
+        }
 
         /// Remove the handler of the given command.
         void RemoveCommand(const std::string& name);
 
+        /**
+         * @brief Set the queue capacity, overflow policy and concurrency limit of a command.
+         * @details
+         *  Options only take effect when commands are dispatched to the thread pool,
+         *  which is enabled by the "command-threads" option.
+         */
+        void SetCommandOptions(const std::string& name, const Executors::CommandDispatcher::CommandOptions& options)
+        {
+            Dispatcher.SetOptions(name, options);
+        }
+        /**
+         * @brief Change how frames of the main loop are paced, takes effect from the next frame.
+         * @details
+         *  Options are initialized from the "update-mode", "update-frequency", "update-spin" and "update-idle"
+         *  options before OnInstall(). The default is variable mode at 100 frames per second.
+         */
+        void SetUpdateOptions(const Executors::UpdateScheduler::Options& options)
+        {
+            FrameScheduler.SetOptions(options);
+        }
+        /// Get the statistics of frames of the main loop, including their durations and deadline misses.
+        [[nodiscard]] Executors::UpdateScheduler::FrameStatistics GetUpdateStatistics() const
+        {
+            return FrameScheduler.GetStatistics();
+        }
+        /// Get the time step of the current frame, use it in OnUpdate() for variable-step updates.
+        [[nodiscard]] inline std::chrono::steady_clock::duration GetFrameDelta() const noexcept
+        {
+            return FrameScheduler.GetFrameDelta();
+        }
+
+        /// Get the statistics of a command dispatched to the thread pool.
+        [[nodiscard]] Executors::CommandDispatcher::CommandStatistics GetCommandStatistics(const std::string& name)
+        {
+            return Dispatcher.GetStatistics(name);
+        }
+
         /**
          * @brief Add a subscription to a specific channel.
          * @param channel_name Name of the channel to subscribe.
          * @param handler Handler for messages from the channel.
          */
         void AddSubscription(const std::string& channel_name, const MessageHandler& handler);
+        /**
+         * @brief Add a subscription whose handler receives views of the channel name and the content.
+         * @details Handlers executed on the message thread receive views of the received message without copies.
+         */
+        void AddSubscription(const std::string& channel_name, ChannelMessageHandler handler);
+        /**
+         * @brief Handle messages of the given channel in the strand of the given key.
+         * @details
+         *  Channels with the same strand key are handled in one serial order.
+         *  Only takes effect when messages are handled in strands, which is enabled by the "message-threads" option.
+         */
+        void SetSubscriptionStrand(const std::string& channel_name, const std::string& strand_key);
         /**
          * @brief Remove the subscriptions to the given channel.
          * @param channel_name Name of the channel.
@@ -165,6 +669,79 @@ namespace Gaia::Framework
          */
         void RemoveSubscription(const std::string& channel_name);
 
+        /**
+         * @brief Create a typed configuration profile of this service.
+         * @tparam SettingsType Type of the struct of settings.
+         * @param defaults Values of items which do not exist in the configuration unit.
+         * @return The profile, bind its items and then load it.
+         * @details
+         *  The profile is reloaded when the configuration unit of this service is updated,
+         *  and when a reload of the unit is requested, see ConfigurationProfile::HandleNotification().
+         */
+        template <typename SettingsType>
+        std::shared_ptr<Clients::ConfigurationProfile<SettingsType>>
+        AddConfigurationProfile(SettingsType defaults = {})
+        {
+            auto profile = std::make_shared<Clients::ConfigurationProfile<SettingsType>>(
+                    *Configurator, std::move(defaults));
+            std::weak_ptr<Clients::ConfigurationProfile<SettingsType>> weak_profile = profile;
+            AddSubscription(Clients::ConfigurationClient::LoadChannel, [weak_profile](const std::string& content){
+                if (auto profile = weak_profile.lock())
+                {
+                    profile->HandleNotification(Clients::ConfigurationClient::LoadChannel, content);
+                }
+            });
+            AddSubscription(Clients::ConfigurationClient::UpdateChannel, [weak_profile](const std::string& content){
+                if (auto profile = weak_profile.lock())
+                {
+                    profile->HandleNotification(Clients::ConfigurationClient::UpdateChannel, content);
+                }
+            });
+            return profile;
+        }
+
+#ifdef GAIA_FRAMEWORK_COROUTINES
+        /**
+         * @brief Start a coroutine task on the scheduler of this service.
+         * @details
+         *  Tasks run on the main thread in every frame before OnUpdate(), and only while the service is enabled.
+         *  Waiting tasks hold no thread, so thousands of flows can be in progress at the same time.
+         */
+        void Spawn(Coroutines::Task task)
+        {
+            TaskScheduler.Spawn(std::move(task));
+        }
+        /// Suspend the current task for the given duration.
+        [[nodiscard]] Coroutines::Scheduler::SleepAwaiter Sleep(std::chrono::steady_clock::duration duration)
+        {
+            return TaskScheduler.Sleep(duration);
+        }
+        /**
+         * @brief Suspend the current task until the next message of a channel arrives.
+         * @return Content of the message, or std::nullopt if the service is uninstalled.
+         * @details
+         *  Channels without subscriptions are subscribed by the message thread before it consumes messages again,
+         *  so messages published within the first socket timeout of a new channel may be missed.
+         *  Awaited channels stay subscribed.
+         */
+        [[nodiscard]] MessageAwaiter NextMessage(const std::string& channel_name)
+        {
+            return {*this, channel_name};
+        }
+        /**
+         * @brief Send a request to a command of a service and suspend the current task until its reply.
+         * @return Reply of the request, which tells whether the command succeeded, failed or timed out.
+         */
+        [[nodiscard]] Coroutines::CallbackAwaiter<Clients::RequestClient::Reply> SendServiceCommandAsync(
+                std::string service_name, std::string command_name, std::string content = "",
+                std::chrono::milliseconds timeout = std::chrono::milliseconds(1000));
+        /// Get the coroutine scheduler of this service.
+        [[nodiscard]] inline Coroutines::Scheduler& GetScheduler() noexcept
+        {
+            return TaskScheduler;
+        }
+#endif
+
         /// Get connection of this service.
         [[nodiscard]] inline const std::shared_ptr<sw::redis::Redis>& GetConnection() const noexcept
         {
@@ -173,7 +750,7 @@ namespace Gaia::Framework
         /// Get communicator of this service.
         [[nodiscard]] inline sw::redis::Subscriber* GetCommunicator() const noexcept
         {
-            return Subscriber.get();
+            return std::atomic_load(&Subscriber).get();
         }
         /// Get log client of this service.
         [[nodiscard]] inline Clients::LogClient* GetLogger() const noexcept
@@ -262,6 +839,13 @@ namespace Gaia::Framework
          * @retval false Launcher should stop the program.
          */
         bool Update();
+        /**
+         * @brief Block until the next frame is due, invoked between two Update().
+         * @details
+         *  In event-driven mode, it returns when messages arrive, coroutine tasks are ready or their timers
+         *  expire, or the idle timeout passes.
+         */
+        void WaitForUpdate();
         /**
          * @brief Uninstall this service.
          */
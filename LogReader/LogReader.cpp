@@ -0,0 +1,117 @@
+#include <GaiaFramework/Clients/LogSegmentReader.hpp>
+#include <GaiaFramework/Clients/LogFormatter.hpp>
+#include <boost/program_options.hpp>
+#include <ctime>
+#include <iostream>
+#include <string>
+
+using namespace Gaia::Framework::Clients;
+
+/// Convert seconds since the epoch into nanoseconds since the epoch.
+std::int64_t ToTimestamp(double seconds)
+{
+    return static_cast<std::int64_t>(seconds * 1e9);
+}
+
+/// Print a log entry in the format of "date time|severity|author|text".
+void PrintEntry(const LogEntry& entry)
+{
+    auto global_time = static_cast<std::time_t>(entry.Timestamp / 1000000000);
+    std::tm local_time {};
+    localtime_r(&global_time, &local_time);
+    char date_text[16];
+    std::strftime(date_text, sizeof(date_text), "%Y-%m-%d ", &local_time);
+
+    std::string line(date_text);
+    LogFormatter::AppendTimestamp(line, std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(
+                    std::chrono::nanoseconds(entry.Timestamp))));
+    line.push_back('|');
+    line.append(LogFormatter::GetSeverityName(entry.Severity));
+    line.push_back('|');
+    if (entry.Author.empty() && entry.AuthorId != LogSegment::GetAuthorId(""))
+    {
+        line.append("#" + std::to_string(entry.AuthorId));
+    }
+    else
+    {
+        line.append(entry.Author);
+    }
+    line.push_back('|');
+    line.append(entry.Text);
+    std::cout << line << '\n';
+}
+
+int main(int argc, char** argv)
+{
+    using namespace boost::program_options;
+
+    options_description option_description("Query records from binary log segments");
+    option_description.add_options()
+            ("help,?", "show help message.")
+            ("directory,d", value<std::string>()->default_value("."), "directory of segment files.")
+            ("prefix,p", value<std::string>()->default_value(""), "only read segment files with this prefix.")
+            ("begin,b", value<double>(), "only read records at or after this time, in seconds since the epoch.")
+            ("end,e", value<double>(), "only read records at or before this time, in seconds since the epoch.")
+            ("severity,s", value<std::string>(), "only read records at or above this severity.")
+            ("author,a", value<std::string>(), "only read records of this author.")
+            ("limit,n", value<std::size_t>(), "maximum count of records to print.");
+    positional_options_description positional_description;
+    positional_description.add("directory", 1);
+
+    variables_map option_variables;
+    try
+    {
+        store(command_line_parser(argc, argv).options(option_description)
+                      .positional(positional_description).run(), option_variables);
+        notify(option_variables);
+    }
+    catch (std::exception& error)
+    {
+        std::cout << error.what() << std::endl;
+        return 1;
+    }
+
+    if (option_variables.count("help"))
+    {
+        std::cout << option_description << std::endl;
+        return 0;
+    }
+
+    LogQuery query;
+    if (option_variables.count("begin"))
+    {
+        query.BeginTimestamp = ToTimestamp(option_variables["begin"].as<double>());
+    }
+    if (option_variables.count("end"))
+    {
+        query.EndTimestamp = ToTimestamp(option_variables["end"].as<double>());
+    }
+    if (option_variables.count("severity"))
+    {
+        auto severity = LogFormatter::ParseSeverity(option_variables["severity"].as<std::string>());
+        if (!severity.has_value())
+        {
+            std::cout << "Invalid severity: " << option_variables["severity"].as<std::string>() << std::endl;
+            return 1;
+        }
+        query.MinimumSeverity = *severity;
+    }
+    if (option_variables.count("author"))
+    {
+        query.Author = option_variables["author"].as<std::string>();
+    }
+    std::size_t limit = option_variables.count("limit") ?
+            option_variables["limit"].as<std::size_t>() : std::numeric_limits<std::size_t>::max();
+
+    LogSegmentReader reader(option_variables["directory"].as<std::string>(),
+                            option_variables["prefix"].as<std::string>());
+    std::size_t printed_count = 0;
+    reader.Query(query, [&printed_count, limit](const LogEntry& entry){
+        if (printed_count >= limit) return false;
+        PrintEntry(entry);
+        return ++printed_count < limit;
+    });
+    std::cout.flush();
+    return 0;
+}